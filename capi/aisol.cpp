@@ -0,0 +1,110 @@
+// C ABI over Klondike::EnvBatch, see aisol.h. Build as a shared library:
+//   g++ -std=c++17 -O2 -shared -fPIC -fvisibility=hidden -pthread -I. capi/aisol.cpp -o libaisol.so
+
+#include "aisol.h"
+
+#include <cstring>
+#include <new>
+#include <vector>
+
+#include "engine/envbatch.hpp"
+
+struct aisol_batch {
+    Klondike::EnvBatch envs;
+    std::vector<float> rewards;
+    std::vector<std::uint8_t> dones;
+    std::vector<std::int32_t> finalScores;
+    std::vector<std::uint8_t> masks;
+    std::vector<std::uint64_t> maskBits;
+    std::vector<std::uint8_t> obs;
+    std::vector<float> obsFloat;
+    Klondike::EnvBatch::Outputs out;
+
+    aisol_batch(int n, int threads, std::uint64_t seed, int max_steps, bool float_obs)
+        : envs(n, threads, seed, max_steps), rewards(n), dones(n), finalScores(n),
+          masks(static_cast<std::size_t>(n) * Klondike::ACTION_COUNT),
+          maskBits(static_cast<std::size_t>(n) * Klondike::ACTION_MASK_WORDS),
+          obs(static_cast<std::size_t>(n) * Klondike::OBS_SIZE),
+          obsFloat(float_obs ? static_cast<std::size_t>(n) * Klondike::OBS_SIZE : 0) {
+        out.rewards = rewards.data();
+        out.dones = dones.data();
+        out.final_scores = finalScores.data();
+        out.masks = masks.data();
+        out.mask_bits = maskBits.data();
+        out.obs = obs.data();
+        out.obs_float = float_obs ? obsFloat.data() : nullptr;
+        afterReset();
+    }
+
+    // a reset has no reward or done to report
+    void afterReset() {
+        std::memset(rewards.data(), 0, rewards.size() * sizeof(float));
+        std::memset(dones.data(), 0, dones.size());
+        for (int env = 0; env < envs.size(); ++env) finalScores[env] = envs.state(env).getScore();
+        envs.writeCurrent(out);
+    }
+};
+
+extern "C" {
+
+int aisol_abi_version(void) { return AISOL_ABI_VERSION; }
+
+int aisol_action_count(void) { return Klondike::ACTION_COUNT; }
+int aisol_mask_words(void) { return Klondike::ACTION_MASK_WORDS; }
+int aisol_obs_channels(void) { return Klondike::OBS_CHANNELS; }
+int aisol_obs_width(void) { return Klondike::OBS_WIDTH; }
+
+aisol_batch* aisol_create(int32_t num_envs, int32_t threads, uint64_t seed, int32_t max_steps, int32_t float_obs) {
+    if (num_envs <= 0) return nullptr;
+    if (max_steps <= 0) max_steps = Klondike::EnvBatch::DefaultMaxSteps;
+    try {
+        return new aisol_batch(num_envs, threads, seed, max_steps, float_obs != 0);
+    } catch (...) { // nothing may cross the C boundary
+        return nullptr;
+    }
+}
+
+void aisol_destroy(aisol_batch* batch) { delete batch; }
+
+int32_t aisol_num_envs(const aisol_batch* batch) { return batch ? batch->envs.size() : 0; }
+
+int aisol_reset(aisol_batch* batch, const uint64_t* deal_seeds) {
+    if (!batch) return AISOL_ERROR_NULL_BATCH;
+    try { // the pool queues work in a std::deque, which can throw
+        if (deal_seeds) batch->envs.reset(deal_seeds);
+        else batch->envs.reset();
+        batch->afterReset();
+    } catch (const std::bad_alloc&) {
+        return AISOL_ERROR_OUT_OF_MEMORY;
+    } catch (...) {
+        return AISOL_ERROR_INTERNAL;
+    }
+    return AISOL_OK;
+}
+
+int aisol_step(aisol_batch* batch, const int32_t* actions) {
+    if (!batch) return AISOL_ERROR_NULL_BATCH;
+    if (!actions) return AISOL_ERROR_NULL_ARGUMENT;
+    try {
+        batch->envs.step(actions, batch->out);
+    } catch (const std::bad_alloc&) {
+        return AISOL_ERROR_OUT_OF_MEMORY;
+    } catch (...) {
+        return AISOL_ERROR_INTERNAL;
+    }
+    return AISOL_OK;
+}
+
+float* aisol_rewards(aisol_batch* batch) { return batch ? batch->rewards.data() : nullptr; }
+uint8_t* aisol_dones(aisol_batch* batch) { return batch ? batch->dones.data() : nullptr; }
+int32_t* aisol_final_scores(aisol_batch* batch) { return batch ? batch->finalScores.data() : nullptr; }
+uint8_t* aisol_masks(aisol_batch* batch) { return batch ? batch->masks.data() : nullptr; }
+uint64_t* aisol_mask_bits(aisol_batch* batch) { return batch ? batch->maskBits.data() : nullptr; }
+uint8_t* aisol_obs(aisol_batch* batch) { return batch ? batch->obs.data() : nullptr; }
+float* aisol_obs_float(aisol_batch* batch) { return batch ? batch->out.obs_float : nullptr; }
+
+uint64_t aisol_deal_seed(const aisol_batch* batch, int32_t env) {
+    return (batch && env >= 0 && env < batch->envs.size()) ? batch->envs.dealSeed(env) : 0;
+}
+
+}
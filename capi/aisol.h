@@ -0,0 +1,75 @@
+#ifndef AISOL_H
+#define AISOL_H
+
+/* C ABI over the Klondike engine, for trainers that load the game in-process (ctypes, cffi, Julia ccall, C++).
+ * A batch owns its output buffers; the pointers below stay valid until aisol_destroy() and are rewritten in
+ * place by every reset/step, so they can be wrapped as arrays once, zero-copy.
+ *
+ * Shapes, with N = aisol_num_envs():
+ *   rewards      float   [N]                                score delta of the last step
+ *   dones        uint8   [N]                                1 if the episode ended (already reset in place)
+ *   final_scores int32   [N]                                score the last step ended on
+ *   masks        uint8   [N, aisol_action_count()]          legal actions for the next step
+ *   mask_bits    uint64  [N, aisol_mask_words()]            same mask, packed, action a at bit a % 64 of word a / 64
+ *   obs          uint8   [N, aisol_obs_channels(), aisol_obs_width()]
+ *   obs_float    float   [N, aisol_obs_channels(), aisol_obs_width()]   only written if enabled at create
+ *
+ * Functions returning int give AISOL_OK or a negative AISOL_ERROR_* code. Not thread-safe per batch. */
+
+#include <stdint.h>
+
+#if defined(_WIN32)
+#define AISOL_API __declspec(dllexport)
+#else
+#define AISOL_API __attribute__((visibility("default")))
+#endif
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#define AISOL_ABI_VERSION 1
+
+#define AISOL_OK 0
+#define AISOL_ERROR_NULL_BATCH -1
+#define AISOL_ERROR_NULL_ARGUMENT -2
+#define AISOL_ERROR_OUT_OF_MEMORY -3 /* the batch may be half stepped, reset it before going on */
+#define AISOL_ERROR_INTERNAL -4
+
+typedef struct aisol_batch aisol_batch;
+
+AISOL_API int aisol_abi_version(void);
+
+AISOL_API int aisol_action_count(void);
+AISOL_API int aisol_mask_words(void);
+AISOL_API int aisol_obs_channels(void);
+AISOL_API int aisol_obs_width(void);
+
+/* threads counts the calling thread, 0 uses every core; max_steps <= 0 keeps the default episode cap.
+ * Returns NULL if the batch can't be built. The batch starts out reset with fresh deals from seed. */
+AISOL_API aisol_batch* aisol_create(int32_t num_envs, int32_t threads, uint64_t seed, int32_t max_steps, int32_t float_obs);
+AISOL_API void aisol_destroy(aisol_batch* batch);
+
+AISOL_API int32_t aisol_num_envs(const aisol_batch* batch);
+
+/* deal_seeds: one deal number per env, or NULL for fresh deals from the env streams */
+AISOL_API int aisol_reset(aisol_batch* batch, const uint64_t* deal_seeds);
+/* actions: one action id per env; an illegal or out-of-range id leaves that game as it was */
+AISOL_API int aisol_step(aisol_batch* batch, const int32_t* actions);
+
+AISOL_API float* aisol_rewards(aisol_batch* batch);
+AISOL_API uint8_t* aisol_dones(aisol_batch* batch);
+AISOL_API int32_t* aisol_final_scores(aisol_batch* batch);
+AISOL_API uint8_t* aisol_masks(aisol_batch* batch);
+AISOL_API uint64_t* aisol_mask_bits(aisol_batch* batch);
+AISOL_API uint8_t* aisol_obs(aisol_batch* batch);
+AISOL_API float* aisol_obs_float(aisol_batch* batch); /* NULL unless float_obs was set at create */
+
+/* deal number of the episode env is playing, to replay it */
+AISOL_API uint64_t aisol_deal_seed(const aisol_batch* batch, int32_t env);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif
@@ -0,0 +1,114 @@
+#pragma once
+
+// Fixed discrete action space over Klondike::Move, so a policy head can index moves directly.
+// The layout is part of the interface - append new ranges at the end, never reorder:
+//   0                      Draw (stock -> waste, or recycle)
+//   1   + t                waste -> tableau t
+//   8   + f                waste -> foundation f
+//   12  + t*4 + f          tableau t -> foundation f
+//   40  + f*7 + t          foundation f -> tableau t
+//   68  + (from*6 + to')*13 + (count - 1)
+//                          tableau from -> tableau to, run of count cards; to' skips from (to' = to > from ? to - 1 : to)
+
+#include <cstdint>
+#include <cstring>
+
+#include "klondike.hpp"
+
+namespace Klondike {
+
+    namespace Action {
+        constexpr int Draw = 0;
+        constexpr int WasteToTableau = Draw + 1;
+        constexpr int WasteToFoundation = WasteToTableau + NO_OF_TABLEAUS;
+        constexpr int TableauToFoundation = WasteToFoundation + NO_OF_SUITS;
+        constexpr int FoundationToTableau = TableauToFoundation + NO_OF_TABLEAUS * NO_OF_SUITS;
+        constexpr int TableauToTableau = FoundationToTableau + NO_OF_SUITS * NO_OF_TABLEAUS;
+        constexpr int Count = TableauToTableau + NO_OF_TABLEAUS * (NO_OF_TABLEAUS - 1) * SUIT_LENGTH;
+    }
+
+    constexpr int ACTION_COUNT = Action::Count;
+    static_assert(ACTION_COUNT == 614, "action ids are baked into trained policies, don't move them");
+
+    constexpr int actionOf(const Move& move) {
+        switch (move.kind) {
+        case MoveKind::Draw:
+            return Action::Draw;
+        case MoveKind::WasteToTableau:
+            return Action::WasteToTableau + move.to;
+        case MoveKind::WasteToFoundation:
+            return Action::WasteToFoundation + move.to;
+        case MoveKind::TableauToFoundation:
+            return Action::TableauToFoundation + move.from * NO_OF_SUITS + move.to;
+        case MoveKind::FoundationToTableau:
+            return Action::FoundationToTableau + move.from * NO_OF_TABLEAUS + move.to;
+        case MoveKind::TableauToTableau: {
+            const int to = (move.to > move.from) ? move.to - 1 : move.to;
+            return Action::TableauToTableau + (move.from * (NO_OF_TABLEAUS - 1) + to) * SUIT_LENGTH + (move.count - 1);
+        }
+        }
+        return -1;
+    }
+
+    // inverse of actionOf(); only meaningful for 0 <= action < ACTION_COUNT
+    constexpr Move moveOf(int action) {
+        if (action < Action::WasteToTableau) return {MoveKind::Draw, 0, 0, 1};
+        if (action < Action::WasteToFoundation) {
+            return {MoveKind::WasteToTableau, 0, static_cast<std::uint8_t>(action - Action::WasteToTableau), 1};
+        }
+        if (action < Action::TableauToFoundation) {
+            return {MoveKind::WasteToFoundation, 0, static_cast<std::uint8_t>(action - Action::WasteToFoundation), 1};
+        }
+        if (action < Action::FoundationToTableau) {
+            const int idx = action - Action::TableauToFoundation;
+            return {MoveKind::TableauToFoundation, static_cast<std::uint8_t>(idx / NO_OF_SUITS),
+                    static_cast<std::uint8_t>(idx % NO_OF_SUITS), 1};
+        }
+        if (action < Action::TableauToTableau) {
+            const int idx = action - Action::FoundationToTableau;
+            return {MoveKind::FoundationToTableau, static_cast<std::uint8_t>(idx / NO_OF_TABLEAUS),
+                    static_cast<std::uint8_t>(idx % NO_OF_TABLEAUS), 1};
+        }
+        const int idx = action - Action::TableauToTableau;
+        const int count = idx % SUIT_LENGTH + 1;
+        const int pair = idx / SUIT_LENGTH;
+        const int from = pair / (NO_OF_TABLEAUS - 1);
+        int to = pair % (NO_OF_TABLEAUS - 1);
+        if (to >= from) to++;
+        return {MoveKind::TableauToTableau, static_cast<std::uint8_t>(from), static_cast<std::uint8_t>(to),
+                static_cast<std::uint8_t>(count)};
+    }
+
+    constexpr bool isValidAction(int action) { return action >= 0 && action < ACTION_COUNT; }
+
+    // writes the ids of every legal move into actions (room for MAX_LEGAL_MOVES), returns how many
+    inline int legalActions(const State& state, std::int32_t* actions) {
+        MoveList moves;
+        legalMoves(state, moves);
+        for (int i = 0; i < moves.size(); ++i) actions[i] = actionOf(moves[i]);
+        return moves.size();
+    }
+
+    constexpr int ACTION_MASK_WORDS = (ACTION_COUNT + 63) / 64;
+
+    // Legal-action mask over the action space, from the same move generator (and so the same Rules:: that
+    // Logic:: uses in the GUI). bytes gets ACTION_COUNT 0/1 entries, bits gets ACTION_MASK_WORDS words with
+    // action a at bit a % 64 of word a / 64. Either may be nullptr. Returns the number of legal actions.
+    inline int legalActionMask(const MoveList& moves, std::uint8_t* bytes, std::uint64_t* bits) {
+        if (bytes) std::memset(bytes, 0, ACTION_COUNT);
+        if (bits) std::memset(bits, 0, ACTION_MASK_WORDS * sizeof(std::uint64_t));
+        for (const Move& move : moves) {
+            const int action = actionOf(move);
+            if (bytes) bytes[action] = 1;
+            if (bits) bits[action >> 6] |= std::uint64_t {1} << (action & 63);
+        }
+        return moves.size();
+    }
+    inline int legalActionMask(const State& state, std::uint8_t* bytes, std::uint64_t* bits) {
+        MoveList moves;
+        legalMoves(state, moves);
+        return legalActionMask(moves, bytes, bits);
+    }
+
+    inline bool isActionSet(const std::uint64_t* bits, int action) { return (bits[action >> 6] >> (action & 63)) & 1; }
+}
@@ -0,0 +1,176 @@
+#pragma once
+
+// Prebaked asset pack: every image already decoded to RGBA32 (byte order R, G, B, A) in one file, so the GUI
+// maps it once and uploads straight from the mapping - no PNG decode, no per-file open/read.
+// Written by tools/pack.cpp, read by the GUI (`solitaire --pack FILE`, assets/assets.pack by default).
+//
+// Layout: Header, then `count` Entry records, then the pixel blocks (each 64-byte aligned, rows tightly packed
+// at `pitch` bytes). An entry is named after the asset path the GUI asks for ("assets/cards/back.png");
+// pre-scaled copies of the same image add "@WxH" ("assets/cards/back.png@328x465").
+// Little-endian, like everything this repo runs on. No SDL here, the tool and the loader both use it.
+
+#include <cstdint>
+#include <cstdio>
+#include <cstring>
+#include <string>
+#include <vector>
+
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+namespace Klondike {
+    namespace Pack {
+
+        constexpr std::uint32_t Magic = 0x4B41504B; // "KPAK"
+        constexpr std::uint32_t Version = 1;
+        constexpr std::size_t NameBytes = 64;
+
+        struct Header {
+            std::uint32_t magic;
+            std::uint32_t version;
+            std::uint32_t count;
+            std::uint32_t reserved;
+            std::uint64_t bytes; // whole file
+        };
+
+        struct Entry {
+            char name[NameBytes]; // zero padded
+            std::uint32_t width;
+            std::uint32_t height;
+            std::uint32_t pitch;
+            std::uint32_t reserved;
+            std::uint64_t offset; // from the start of the file
+        };
+
+        inline std::string scaledName(const std::string& name, int width, int height) {
+            return name + "@" + std::to_string(width) + "x" + std::to_string(height);
+        }
+
+        // collects images in memory and writes the file in one go
+        class Writer {
+        private:
+            struct Image {
+                std::string name;
+                std::uint32_t width, height;
+                std::vector<std::uint8_t> pixels;
+            };
+            std::vector<Image> images;
+
+            static std::uint64_t alignUp(std::uint64_t bytes) { return (bytes + 63) & ~std::uint64_t {63}; }
+
+        public:
+            // rgba holds height rows of pitch bytes; false if the name doesn't fit
+            bool add(const std::string& name, std::uint32_t width, std::uint32_t height, const void* rgba, std::uint32_t pitch) {
+                if (name.size() >= NameBytes) return false;
+                Image image {name, width, height, std::vector<std::uint8_t>(static_cast<std::size_t>(width) * 4 * height)};
+                for (std::uint32_t y = 0; y < height; ++y) {
+                    std::memcpy(&image.pixels[static_cast<std::size_t>(y) * width * 4],
+                                static_cast<const std::uint8_t*>(rgba) + static_cast<std::size_t>(y) * pitch, width * 4);
+                }
+                images.push_back(std::move(image));
+                return true;
+            }
+
+            std::size_t size() const { return images.size(); }
+
+            bool write(const std::string& path) const {
+                std::vector<Entry> entries(images.size());
+                std::uint64_t at = alignUp(sizeof(Header) + sizeof(Entry) * images.size());
+                for (std::size_t i = 0; i < images.size(); ++i) {
+                    std::memset(&entries[i], 0, sizeof(Entry));
+                    std::memcpy(entries[i].name, images[i].name.data(), images[i].name.size());
+                    entries[i].width = images[i].width;
+                    entries[i].height = images[i].height;
+                    entries[i].pitch = images[i].width * 4;
+                    entries[i].offset = at;
+                    at = alignUp(at + images[i].pixels.size());
+                }
+                Header header {Magic, Version, static_cast<std::uint32_t>(images.size()), 0, at};
+
+                std::FILE* file = std::fopen(path.c_str(), "wb");
+                if (!file) return false;
+                bool ok = std::fwrite(&header, sizeof(header), 1, file) == 1;
+                if (!entries.empty()) ok = ok && std::fwrite(entries.data(), sizeof(Entry), entries.size(), file) == entries.size();
+                static const std::uint8_t zeros[64] = {};
+                std::uint64_t written = sizeof(Header) + sizeof(Entry) * entries.size();
+                for (std::size_t i = 0; ok && i < images.size(); ++i) {
+                    ok = std::fwrite(zeros, 1, entries[i].offset - written, file) == entries[i].offset - written
+                      && std::fwrite(images[i].pixels.data(), 1, images[i].pixels.size(), file) == images[i].pixels.size();
+                    written = entries[i].offset + images[i].pixels.size();
+                }
+                ok = ok && std::fwrite(zeros, 1, at - written, file) == at - written;
+                return std::fclose(file) == 0 && ok;
+            }
+        };
+
+        // read-only mapping of a pack; pixels() points straight into it, valid until close()
+        class Reader {
+        private:
+            const std::uint8_t* base {nullptr};
+            std::size_t bytes {0};
+
+            const Header& header() const { return *reinterpret_cast<const Header*>(base); }
+
+        public:
+            Reader() = default;
+            ~Reader() { close(); }
+            Reader(const Reader&) = delete;
+            Reader& operator=(const Reader&) = delete;
+
+            // false if the file is missing, truncated or not a pack of this version
+            bool open(const std::string& path) {
+                close();
+                const int fd = ::open(path.c_str(), O_RDONLY);
+                if (fd < 0) return false;
+                struct stat info;
+                if (fstat(fd, &info) != 0 || info.st_size < static_cast<off_t>(sizeof(Header))) {
+                    ::close(fd);
+                    return false;
+                }
+                void* mem = mmap(nullptr, info.st_size, PROT_READ, MAP_PRIVATE, fd, 0);
+                ::close(fd);
+                if (mem == MAP_FAILED) return false;
+                base = static_cast<const std::uint8_t*>(mem);
+                bytes = static_cast<std::size_t>(info.st_size);
+                if (header().magic != Magic || header().version != Version || header().bytes != bytes
+                    || sizeof(Header) + sizeof(Entry) * static_cast<std::uint64_t>(header().count) > bytes) {
+                    close();
+                    return false;
+                }
+                for (int i = 0; i < count(); ++i) { // bounds are checked once here, not on every lookup
+                    const Entry& e = entry(i);
+                    // compared against what's left after the offset, so a corrupt offset or size can't wrap around
+                    if (e.name[NameBytes - 1] != '\0' || e.pitch < static_cast<std::uint64_t>(e.width) * 4
+                        || e.offset > bytes || static_cast<std::uint64_t>(e.pitch) * e.height > bytes - e.offset) {
+                        close();
+                        return false;
+                    }
+                }
+                return true;
+            }
+
+            void close() {
+                if (base) munmap(const_cast<std::uint8_t*>(base), bytes);
+                base = nullptr;
+                bytes = 0;
+            }
+
+            bool isOpen() const { return base != nullptr; }
+            int count() const { return base ? static_cast<int>(header().count) : 0; }
+            const Entry& entry(int i) const { return reinterpret_cast<const Entry*>(base + sizeof(Header))[i]; }
+
+            // nullptr if there's no such image; a pack holds a few dozen, a scan is fine
+            const Entry* find(const std::string& name) const {
+                if (name.size() >= NameBytes) return nullptr;
+                for (int i = 0; i < count(); ++i) {
+                    if (std::strncmp(entry(i).name, name.c_str(), NameBytes) == 0) return &entry(i);
+                }
+                return nullptr;
+            }
+
+            const std::uint8_t* pixels(const Entry& e) const { return base + e.offset; }
+        };
+    }
+}
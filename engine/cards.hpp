@@ -0,0 +1,34 @@
+#pragma once
+
+// Card model shared by the engine, the GUI and everything keyed by card ids (observations, hashing, pixels).
+
+#include <cstdint>
+
+namespace Klondike {
+
+    enum class Suit { Hearts, Diamonds, Clubs, Spades };
+
+    enum class Colour {
+        Red,
+        Black
+    };
+
+    constexpr int SUIT_LENGTH = 13;
+    constexpr int NO_OF_SUITS = 4;
+    constexpr int NO_OF_TABLEAUS = 7;
+    constexpr int NO_OF_CARDS = SUIT_LENGTH * NO_OF_SUITS;
+
+    constexpr int Ace = 1; // RANKS ARE 1-INDEXED (1 to 13), same as the GUI Card
+    constexpr int King = 13;
+
+    // a card is just its id: suit * 13 + (rank - 1), which is also its index in Deck::cardStore
+    using Card = std::uint8_t;
+    constexpr Card NoCard = 0xFF;
+
+    constexpr Card makeCard(Suit suit, int rank) { return static_cast<Card>(static_cast<int>(suit) * SUIT_LENGTH + (rank - 1)); }
+    constexpr int rankOf(Card card) { return card % SUIT_LENGTH + 1; }
+    constexpr Suit suitOf(Card card) { return static_cast<Suit>(card / SUIT_LENGTH); }
+    constexpr Colour colourOf(Card card) {
+        return (suitOf(card) == Suit::Hearts || suitOf(card) == Suit::Diamonds) ? Colour::Red : Colour::Black;
+    }
+}
@@ -0,0 +1,157 @@
+#pragma once
+
+// N Klondike games stepped together for training.
+// Rewards are the Statistics score deltas from the engine, finished episodes are reset in place,
+// and every result goes straight into arrays the caller owns (one slot per env).
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+#include "klondike.hpp"
+#include "actions.hpp"
+#include "observation.hpp"
+#include "rng.hpp"
+#include "threadpool.hpp"
+
+namespace Klondike {
+
+    class EnvBatch {
+    private:
+        std::vector<State> states;
+        std::vector<std::int32_t> steps;      // steps taken in the current episode
+        std::vector<Rng> streams;             // one counter-based stream per env, picks its next deals
+        std::vector<std::uint64_t> dealSeeds; // deal number of the current episode, for replaying it
+
+        ThreadPool pool;
+        int maxSteps;
+
+        static constexpr int Grain = 64; // envs per task; one env step is far too small to schedule on its own
+
+        void resetEnv(int env, std::uint64_t deal_seed) {
+            deal(states[env], deal_seed);
+            dealSeeds[env] = deal_seed;
+            steps[env] = 0;
+        }
+        // the next deal only depends on the env's own stream, never on which thread got there first
+        void resetEnv(int env) { resetEnv(env, streams[env].next64()); }
+
+        void seedStreams(std::uint64_t seed) {
+            for (int env = 0; env < size(); ++env) streams[env] = Rng(seed, static_cast<std::uint64_t>(env));
+        }
+
+    public:
+        static constexpr int DefaultMaxSteps = 1000;
+
+        // threads counts the calling thread; 0 uses every core
+        EnvBatch(int no_of_envs, int threads = 0, std::uint64_t seed = 0, int max_steps = DefaultMaxSteps)
+            : states(no_of_envs), steps(no_of_envs, 0), streams(no_of_envs), dealSeeds(no_of_envs, 0), pool(threads),
+              maxSteps(max_steps) {
+            seedStreams(seed);
+            reset();
+        }
+
+        int size() const { return static_cast<int>(states.size()); }
+        int threads() const { return pool.size(); }
+        const State& state(int env) const { return states[env]; }
+        std::uint64_t dealSeed(int env) const { return dealSeeds[env]; }
+
+        // new deals from every env's stream
+        void reset() {
+            pool.parallelFor(0, size(), Grain, [this](int lo, int hi) {
+                for (int env = lo; env < hi; ++env) resetEnv(env);
+            });
+        }
+        // restarts the streams as if the batch had just been built with this seed
+        void reset(std::uint64_t seed) {
+            seedStreams(seed);
+            reset();
+        }
+        // exact deals, one per env; later automatic resets keep drawing from the env streams
+        void reset(const std::uint64_t* deal_seeds) {
+            pool.parallelFor(0, size(), Grain, [this, deal_seeds](int lo, int hi) {
+                for (int env = lo; env < hi; ++env) resetEnv(env, deal_seeds[env]);
+            });
+        }
+
+        // Where step() writes its results; every pointer is optional and indexed by env.
+        struct Outputs {
+            float* rewards = nullptr;             // [N] score delta of the step
+            std::uint8_t* dones = nullptr;        // [N] 1 when the episode ended (the env has already been reset)
+            std::int32_t* final_scores = nullptr; // [N] score the step ended on, the only place a finished episode's score survives the reset
+            std::uint8_t* masks = nullptr;        // [N, ACTION_COUNT] legal actions for the next step
+            std::uint64_t* mask_bits = nullptr;   // [N, ACTION_MASK_WORDS] same mask, packed
+            std::uint8_t* obs = nullptr;          // [N, OBS_CHANNELS, OBS_WIDTH] observation for the next step
+            float* obs_float = nullptr;           // same observation as floats
+        };
+
+        // Applies actions[i] to env i. An illegal action leaves the game as it was and still counts as a step.
+        void step(const Move* actions, const Outputs& out) {
+            stepWith([actions](int env) { return actions[env]; }, out);
+        }
+
+        // same, with ids from the fixed action space in actions.hpp; out-of-range ids are illegal actions
+        void step(const std::int32_t* actions, const Outputs& out) {
+            // a zero count never passes isLegal(), which is how an out-of-range id turns into a no-op
+            stepWith([actions](int env) { return isValidAction(actions[env]) ? moveOf(actions[env]) : Move {MoveKind::Draw, 0, 0, 0}; }, out);
+        }
+
+        template <typename Action>
+        void step(const Action* actions, float* rewards, std::uint8_t* dones, std::int32_t* final_scores = nullptr) {
+            Outputs out;
+            out.rewards = rewards;
+            out.dones = dones;
+            out.final_scores = final_scores;
+            step(actions, out);
+        }
+
+        // masks and observations for the current states, e.g. right after reset(); rewards/dones are ignored
+        void writeCurrent(const Outputs& out) {
+            pool.parallelFor(0, size(), Grain, [&](int lo, int hi) {
+                MoveList moves;
+                for (int env = lo; env < hi; ++env) {
+                    legalMoves(states[env], moves);
+                    writeMask(env, moves, out.masks, out.mask_bits);
+                    writeObservation(env, out);
+                }
+            });
+        }
+
+    private:
+        void writeMask(int env, const MoveList& moves, std::uint8_t* masks, std::uint64_t* mask_bits) const {
+            if (!masks && !mask_bits) return;
+            legalActionMask(moves, masks ? masks + static_cast<std::size_t>(env) * ACTION_COUNT : nullptr,
+                            mask_bits ? mask_bits + static_cast<std::size_t>(env) * ACTION_MASK_WORDS : nullptr);
+        }
+
+        void writeObservation(int env, const Outputs& out) const {
+            if (out.obs) encodeObservation(states[env], out.obs + static_cast<std::size_t>(env) * OBS_SIZE);
+            if (out.obs_float) encodeObservation(states[env], out.obs_float + static_cast<std::size_t>(env) * OBS_SIZE);
+        }
+
+        template <typename MoveFor>
+        void stepWith(MoveFor move_for, const Outputs& out) {
+            pool.parallelFor(0, size(), Grain, [&](int lo, int hi) {
+                MoveList moves; // one generation serves both terminal detection and the mask
+                for (int env = lo; env < hi; ++env) {
+                    State& state = states[env];
+                    const Move move = move_for(env);
+                    const int delta = (move.count > 0 && isLegal(state, move)) ? apply(state, move).scoreDelta : 0;
+                    steps[env]++;
+
+                    legalMoves(state, moves);
+                    const bool done = state.isWon() || state.isStalled() || moves.empty() || steps[env] >= maxSteps;
+                    if (out.rewards) out.rewards[env] = static_cast<float>(delta);
+                    if (out.dones) out.dones[env] = done ? 1 : 0;
+                    if (out.final_scores) out.final_scores[env] = state.getScore();
+                    if (done) {
+                        resetEnv(env);
+                        legalMoves(state, moves);
+                    }
+                    writeMask(env, moves, out.masks, out.mask_bits);
+                    writeObservation(env, out); // still hot in cache from the step
+                }
+            });
+        }
+    };
+}
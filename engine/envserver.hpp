@@ -0,0 +1,161 @@
+#pragma once
+
+// Server side of shmproto.hpp: hosts an EnvBatch and runs trainer requests straight out of shared memory.
+// `solitaire --serve NAME` lands here before any SDL setup. Linux only.
+// SIGINT and SIGTERM remove the segment on the way out; a segment left behind by a server that died some
+// other way (SIGKILL, a crash) is recognised by its dead pid and replaced on the next start.
+
+#include <cerrno>
+#include <csignal>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <iostream>
+#include <string>
+
+#include "envbatch.hpp"
+#include "shmproto.hpp"
+
+namespace Klondike {
+
+    namespace ServeSignals {
+        inline char path[256]; // the segment to remove, set before the handlers go in
+
+        inline void unlinkAndExit(int sig) {
+            shm_unlink(path);
+            std::signal(sig, SIG_DFL);
+            std::raise(sig); // die of the same signal, the parent sees the usual status
+        }
+    }
+
+    // a segment of ours whose server is gone (or one that was never sized); anything else is left alone
+    inline bool isStaleSegment(const std::string& path) {
+        const int fd = shm_open(path.c_str(), O_RDONLY, 0);
+        if (fd < 0) return false;
+        struct stat info;
+        bool stale = false;
+        if (fstat(fd, &info) == 0) {
+            if (info.st_size < static_cast<off_t>(sizeof(Shm::Header))) {
+                stale = info.st_size == 0;
+            } else if (void* mem = mmap(nullptr, sizeof(Shm::Header), PROT_READ, MAP_SHARED, fd, 0); mem != MAP_FAILED) {
+                const Shm::Header* header = static_cast<const Shm::Header*>(mem);
+                stale = header->magic == Shm::Magic && !Shm::processAlive(header->serverPid);
+                munmap(mem, sizeof(Shm::Header));
+            }
+        }
+        ::close(fd);
+        return stale;
+    }
+
+    // returns the process exit code
+    inline int serveEnvs(const std::string& name, int envs, int threads, int slots, std::uint64_t seed) {
+        if (envs <= 0 || slots <= 0) {
+            std::cerr<<"--serve needs at least one env and one slot"<<std::endl;
+            return 1;
+        }
+        const std::string path = "/" + name;
+        if (path.size() >= sizeof(ServeSignals::path)) {
+            std::cerr<<"Shared memory name too long: "<<name<<std::endl;
+            return 1;
+        }
+        Shm::Header layout {};
+        Shm::describe(layout, static_cast<std::uint32_t>(envs), static_cast<std::uint32_t>(slots));
+        layout.serverPid = static_cast<std::uint32_t>(getpid());
+
+        int fd = shm_open(path.c_str(), O_CREAT | O_EXCL | O_RDWR, 0600);
+        if (fd < 0 && errno == EEXIST && isStaleSegment(path)) {
+            std::cerr<<"Removing shared memory "<<path<<" left behind by a server that is gone"<<std::endl;
+            shm_unlink(path.c_str());
+            fd = shm_open(path.c_str(), O_CREAT | O_EXCL | O_RDWR, 0600);
+        }
+        if (fd < 0) {
+            std::cerr<<"Can't create shared memory "<<path<<": "<<std::strerror(errno)
+                     <<(errno == EEXIST ? " (a running server or another program owns it)" : "")<<std::endl;
+            return 1;
+        }
+        std::strcpy(ServeSignals::path, path.c_str());
+        std::signal(SIGINT, ServeSignals::unlinkAndExit);
+        std::signal(SIGTERM, ServeSignals::unlinkAndExit);
+        auto removeSegment = [&path] {
+            std::signal(SIGINT, SIG_DFL);
+            std::signal(SIGTERM, SIG_DFL);
+            shm_unlink(path.c_str());
+        };
+        if (ftruncate(fd, static_cast<off_t>(layout.segmentBytes)) != 0) {
+            std::cerr<<"Can't size shared memory "<<path<<": "<<std::strerror(errno)<<std::endl;
+            ::close(fd);
+            removeSegment();
+            return 1;
+        }
+        void* mem = mmap(nullptr, layout.segmentBytes, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+        ::close(fd);
+        if (mem == MAP_FAILED) {
+            std::cerr<<"Can't map shared memory "<<path<<": "<<std::strerror(errno)<<std::endl;
+            removeSegment();
+            return 1;
+        }
+
+        // the fresh segment is zeroed, so the counters already read 0; copy everything but them
+        Shm::Header* header = static_cast<Shm::Header*>(mem);
+        std::memcpy(static_cast<void*>(header), &layout, offsetof(Shm::Header, submitted));
+
+        EnvBatch batch(envs, threads, seed);
+        auto outputs = [header](std::uint8_t* slot) {
+            EnvBatch::Outputs out;
+            out.rewards = reinterpret_cast<float*>(slot + header->rewards);
+            out.dones = slot + header->dones;
+            out.final_scores = reinterpret_cast<std::int32_t*>(slot + header->finalScores);
+            out.masks = slot + header->masks;
+            out.mask_bits = reinterpret_cast<std::uint64_t*>(slot + header->maskBits);
+            out.obs = slot + header->obs;
+            return out;
+        };
+        // a reset has no reward or done to report, so those come back zeroed
+        auto afterReset = [&batch, &outputs, envs](std::uint8_t* slot) {
+            const EnvBatch::Outputs out = outputs(slot);
+            std::memset(out.rewards, 0, sizeof(float) * envs);
+            std::memset(out.dones, 0, envs);
+            for (int env = 0; env < envs; ++env) out.final_scores[env] = batch.state(env).getScore();
+            batch.writeCurrent(out);
+        };
+
+        header->serverReady.store(1, std::memory_order_release);
+        Shm::futexWake(header->serverReady);
+        std::cout<<"Serving "<<envs<<" envs on "<<path<<" ("<<slots<<" slots, "<<layout.segmentBytes<<" bytes)"<<std::endl;
+
+        std::uint32_t seq = 0;
+        bool running = true;
+        while (running) {
+            Shm::waitWhileEqual(header->submitted, seq);
+            std::uint8_t* slot = Shm::slotAt(header, seq);
+            const Shm::SlotHeader* request = reinterpret_cast<const Shm::SlotHeader*>(slot);
+            switch (request->command) {
+            case Shm::Step:
+                batch.step(reinterpret_cast<const std::int32_t*>(slot + header->actions), outputs(slot));
+                break;
+            case Shm::Reset:
+                if (request->seed != 0) batch.reset(request->seed);
+                else batch.reset();
+                afterReset(slot);
+                break;
+            case Shm::ResetSeeds:
+                batch.reset(reinterpret_cast<const std::uint64_t*>(slot + header->seeds));
+                afterReset(slot);
+                break;
+            case Shm::Shutdown:
+                running = false;
+                break;
+            default:
+                std::cerr<<"Unknown command "<<request->command<<" in slot "<<seq<<", ignored"<<std::endl;
+                break;
+            }
+            header->completed.store(++seq, std::memory_order_release);
+            Shm::futexWake(header->completed);
+        }
+
+        munmap(mem, layout.segmentBytes);
+        removeSegment();
+        std::cout<<"Server on "<<path<<" shut down after "<<seq<<" requests"<<std::endl;
+        return 0;
+    }
+}
@@ -0,0 +1,104 @@
+#pragma once
+
+// Information-set search: the true deal is never searched. Every move, `samples` determinizations are drawn
+// (determinize() in klondike.hpp - unseen face-down and stock cards reshuffled among their own slots, seen
+// cards kept), each one is searched by its own single-threaded Mcts, and the root statistics are summed per
+// action id. Legal moves at the root only depend on face-up cards, so every sample offers the same actions.
+// Samples run in parallel on the pool, one reusable searcher per chunk, nothing is allocated per move.
+// Sample i of search n always uses the same random streams, so the result doesn't depend on the thread count.
+
+#include <algorithm>
+#include <array>
+#include <cstdint>
+#include <memory>
+#include <vector>
+
+#include "klondike.hpp"
+#include "actions.hpp"
+#include "mcts.hpp"
+#include "rng.hpp"
+#include "threadpool.hpp"
+#include "zobrist.hpp"
+
+namespace Klondike {
+
+    class Ismcts {
+    public:
+        struct Config {
+            int samples = 64;
+            Mcts::Config search = sampleSearch(); // per determinization; its threads and trees are ignored
+            int threads = 0;                      // counts the calling thread, 0 uses every core
+            std::uint64_t seed = 0;
+
+            static Mcts::Config sampleSearch() {
+                Mcts::Config config;
+                config.simulations = 400;
+                config.leafBatch = 1; // one thread per sample, virtual loss has nothing to spread
+                config.maxNodes = 1 << 15;
+                return config;
+            }
+        };
+
+        Ismcts() : Ismcts(Config {}) {}
+        explicit Ismcts(const Config& config)
+            : config(config), pool(config.threads),
+              visits(static_cast<std::size_t>(std::max(config.samples, 1)) * ACTION_COUNT),
+              values(visits.size()) {
+            Mcts::Config per_sample = config.search;
+            per_sample.threads = 1;
+            per_sample.trees = 1;
+            for (int i = 0; i < pool.size(); ++i) searchers.push_back(std::make_unique<Mcts>(per_sample));
+        }
+
+        // Searches the information set of `state`: only what state.seenCards() and the face-up cards give away
+        // is used. Returns the action with the most visits over all samples.
+        Move search(const State& state) {
+            const int samples = std::max(config.samples, 1);
+            const int grain = (samples + pool.size() - 1) / pool.size();
+            const std::uint64_t round = searches++;
+
+            pool.parallelFor(0, samples, grain, [&](int lo, int hi) {
+                Mcts& searcher = *searchers[lo / grain];
+                for (int i = lo; i < hi; ++i) {
+                    const std::uint64_t stream = round * samples + i;
+                    State sample = state;
+                    Rng rng(config.seed, stream);
+                    determinize(sample, rng);
+                    searcher.setRoot(sample);
+                    searcher.reseed(Zobrist::mix(config.seed ^ stream));
+                    searcher.search();
+                    searcher.visitCounts(&visits[static_cast<std::size_t>(i) * ACTION_COUNT],
+                                         &values[static_cast<std::size_t>(i) * ACTION_COUNT]);
+                }
+            });
+
+            // summed in sample order, so the float rounding is the same whatever the chunking was
+            std::fill(totalVisits.begin(), totalVisits.end(), 0);
+            std::fill(totalValues.begin(), totalValues.end(), 0.0);
+            for (int i = 0; i < samples; ++i) {
+                const std::int32_t* sample_visits = &visits[static_cast<std::size_t>(i) * ACTION_COUNT];
+                const double* sample_values = &values[static_cast<std::size_t>(i) * ACTION_COUNT];
+                for (int a = 0; a < ACTION_COUNT; ++a) {
+                    totalVisits[a] += sample_visits[a];
+                    totalValues[a] += sample_values[a];
+                }
+            }
+            const int best = static_cast<int>(std::max_element(totalVisits.begin(), totalVisits.end()) - totalVisits.begin());
+            return totalVisits[best] > 0 ? moveOf(best) : Move {MoveKind::Draw, 0, 0, 0};
+        }
+
+        // aggregated over the samples of the last search(), indexed by action id
+        std::int64_t visitCount(int action) const { return totalVisits[action]; }
+        double actionValue(int action) const { return totalVisits[action] ? totalValues[action] / totalVisits[action] : 0.0; }
+
+    private:
+        Config config;
+        ThreadPool pool;
+        std::vector<std::unique_ptr<Mcts>> searchers; // one per chunk of samples, i.e. per thread
+        std::vector<std::int32_t> visits;             // [samples, ACTION_COUNT] root visits of each sample
+        std::vector<double> values;                   // [samples, ACTION_COUNT] matching value sums
+        std::array<std::int64_t, ACTION_COUNT> totalVisits {};
+        std::array<double, ACTION_COUNT> totalValues {};
+        std::uint64_t searches {0};
+    };
+}
@@ -0,0 +1,550 @@
+#pragma once
+
+// Headless Klondike engine - no SDL in here.
+// solitaire.cpp sits on top of this as a view: its Logic:: rules, Statistics constants
+// and the deal all come from this header, so a trainer can include it on a box without a display.
+
+#include <cstdint>
+#include <array>
+#include <algorithm>
+#include <type_traits>
+
+#include "cards.hpp"
+#include "rng.hpp"
+#include "zobrist.hpp"
+
+namespace Klondike {
+
+    // the one place the stacking rules live; Logic:: in the GUI forwards here
+    namespace Rules {
+        constexpr bool foundationCanStack(Card upper, Card bottom) { // bottom == NoCard for an empty foundation
+            return (bottom == NoCard) ? rankOf(upper) == Ace
+                                      : suitOf(upper) == suitOf(bottom) && rankOf(upper) == rankOf(bottom) + 1;
+        }
+        constexpr bool tableauCanStack(Card upper, Card bottom) { // bottom == NoCard for an empty tableau
+            return (bottom == NoCard) ? rankOf(upper) == King
+                                      : colourOf(upper) != colourOf(bottom) && rankOf(upper) == rankOf(bottom) - 1;
+        }
+    }
+
+    // scoring constants, Statistics:: in the GUI reads these
+    namespace Score {
+        constexpr int CardRevealedOnTableau = 2;
+        constexpr int CardDrawnFromStock = 2; // awarded when a card from the stock/waste is played, not on every click
+        constexpr int CardPutOnFoundation = 5;
+        constexpr int CycleThroughStock = -2;
+        constexpr int CardDrawnFromFoundation = -5;
+    }
+
+    enum class MoveKind : std::uint8_t {
+        Draw,               // stock -> waste, or recycle waste -> stock when the stock is empty
+        WasteToTableau,
+        WasteToFoundation,
+        TableauToFoundation,
+        FoundationToTableau,
+        TableauToTableau
+    };
+
+    struct Move {
+        MoveKind kind;
+        std::uint8_t from;  // pile index for the source (unused for Draw and waste moves)
+        std::uint8_t to;    // pile index for the destination
+        std::uint8_t count; // run length, only > 1 for TableauToTableau
+    };
+
+    // What apply() needs to take a move back exactly: the move, the side effects it can't work out again
+    // (the flip, a first visit to a foundation, a first sight of a stock card, the flags before a recycle)
+    // and the keys from before.
+    struct Undo {
+        Move move;
+        std::uint8_t flags;      // State flags before the move
+        bool revealed;           // turned the card under the moved ones face up
+        bool registered;         // first time this card reached a foundation
+        bool sighted;            // a draw turned up a stock card nobody had seen yet
+        std::int32_t scoreDelta; // what the move scored, also apply()'s result for callers that only want that
+        std::uint64_t talonHash, tableauExact, tableauSum;
+    };
+
+    // Fixed-size value type: copying a position is a memcpy, no pointers anywhere.
+    // Every card that is not on a foundation lives in `cards`: the seven tableaus back to back,
+    // followed by the talon (waste then stock). Foundations only need their top card.
+    // Zobrist keys (zobrist.hpp) ride along and are updated by every move instead of being recomputed.
+    class State {
+    private:
+        std::array<Card, NO_OF_CARDS> cards;
+        std::array<std::uint8_t, NO_OF_TABLEAUS + 1> lengths; // tableaus, then the talon at TALON
+        std::array<std::uint8_t, NO_OF_TABLEAUS> hidden;      // face-down count per tableau, from the bottom
+        std::uint8_t wasteCount;                              // talon[0, wasteCount) is waste, the rest is stock
+        std::array<Card, NO_OF_SUITS> foundationTops;
+        std::uint8_t flags;
+        std::int32_t score;
+        std::uint64_t foundationRegistry; // bit per card that has ever reached a foundation
+        std::uint64_t seen;               // bit per card the player has seen face up; not part of the position keys
+
+        // hash() = talonHash ^ tableauExact, canonicalHash() = talonHash ^ tableauSum
+        std::uint64_t talonHash;    // stock, waste, cursor, foundations and flags - everything but the tableaus
+        std::uint64_t tableauExact; // XOR of the per-column tableau keys
+        std::uint64_t tableauSum;   // sum of mix(column key) over the columns, blind to column order
+
+        static constexpr int TALON = NO_OF_TABLEAUS;
+        static constexpr std::uint8_t FlagChangeMadeInCycle = 1; // same idea as Statistics::change_was_made_in_cycle
+        static constexpr std::uint8_t FlagStalled = 2;           // recycled the stock without any change: the GUI's lose condition
+
+        friend void deal(State& state, std::uint64_t seed);
+        friend Undo apply(State& state, const Move& move);
+        friend void undo(State& state, const Undo& record);
+        friend void determinize(State& state, Rng& rng);
+
+        int pileStart(int pile) const {
+            int start = 0;
+            for (int i = 0; i < pile; ++i) start += lengths[i];
+            return start;
+        }
+        int loose() const { return pileStart(TALON) + lengths[TALON]; }
+
+        // moves cards[src, src + n) so it sits just before what was cards[dst]
+        void relocate(int src, int n, int dst) {
+            if (dst > src) std::rotate(cards.begin() + src, cards.begin() + src + n, cards.begin() + dst);
+            else if (dst < src) std::rotate(cards.begin() + dst, cards.begin() + src, cards.begin() + src + n);
+        }
+        Card eraseAt(int pos) {
+            Card card = cards[pos];
+            std::copy(cards.begin() + pos + 1, cards.begin() + loose(), cards.begin() + pos);
+            cards[loose() - 1] = NoCard; // slots past the loose cards stay NoCard, so equal positions are equal bytes
+            return card;
+        }
+        void insertAt(int pos, Card card) {
+            std::copy_backward(cards.begin() + pos, cards.begin() + loose(), cards.begin() + loose() + 1);
+            cards[pos] = card;
+        }
+
+        void setFlag(std::uint8_t flag, bool on) {
+            const std::uint8_t before = flags;
+            flags = on ? (flags | flag) : (flags & ~flag);
+            talonHash ^= Zobrist::keys.flags[before] ^ Zobrist::keys.flags[flags];
+        }
+        bool changeMadeInCycle() const { return flags & FlagChangeMadeInCycle; }
+
+        // the face-down flip of Stack::handleOriginPileVisibility; true if a card was turned
+        bool revealTableauTop(int idx) {
+            if (lengths[idx] > 0 && hidden[idx] == lengths[idx]) {
+                hidden[idx]--;
+                seen |= std::uint64_t {1} << cards[pileStart(idx) + hidden[idx]];
+                score += Score::CardRevealedOnTableau;
+                setFlag(FlagChangeMadeInCycle, true);
+                return true;
+            }
+            return false;
+        }
+        // true if the card reached a foundation for the first time
+        bool putOnFoundation(Card card, int idx) {
+            foundationTops[idx] = card;
+            talonHash ^= Zobrist::keys.foundation[idx][card];
+            score += Score::CardPutOnFoundation;
+            const std::uint64_t bit = std::uint64_t {1} << card;
+            if (!(foundationRegistry & bit)) {
+                foundationRegistry |= bit;
+                setFlag(FlagChangeMadeInCycle, true);
+                return true;
+            }
+            return false;
+        }
+        Card popTableau(int idx) {
+            Card card = eraseAt(pileStart(idx) + lengths[idx] - 1);
+            lengths[idx]--;
+            return card;
+        }
+        void pushTableau(int idx, Card card) {
+            insertAt(pileStart(idx) + lengths[idx], card);
+            lengths[idx]++;
+        }
+        Card popWaste() {
+            Card card = eraseAt(pileStart(TALON) + wasteCount - 1);
+            talonHash ^= Zobrist::keys.waste[card] ^ Zobrist::keys.cursor[wasteCount] ^ Zobrist::keys.cursor[wasteCount - 1];
+            wasteCount--;
+            lengths[TALON]--;
+            return card;
+        }
+
+        // A column's keys are rebuilt from its (at most 19) cards around each change; moves touch at most two
+        // columns, and the canonical sum needs the column's old key anyway.
+        struct ColumnKeys {
+            std::uint64_t exact;
+            std::uint64_t canonical;
+        };
+        ColumnKeys columnKeys(int idx) const {
+            ColumnKeys keys {0, 0};
+            const int start = pileStart(idx);
+            for (int pos = 0; pos < lengths[idx]; ++pos) {
+                const int face_up = pos >= hidden[idx];
+                keys.exact ^= Zobrist::keys.tableau[idx][cards[start + pos]][face_up];
+                keys.canonical ^= Zobrist::keys.column[cards[start + pos]][face_up];
+            }
+            return keys;
+        }
+        void rehashColumn(int idx, const ColumnKeys& before) {
+            const ColumnKeys after = columnKeys(idx);
+            tableauExact ^= before.exact ^ after.exact;
+            tableauSum += Zobrist::mix(after.canonical) - Zobrist::mix(before.canonical);
+        }
+
+    public:
+        State() : cards {}, lengths {}, hidden {}, wasteCount(0), foundationTops {NoCard, NoCard, NoCard, NoCard},
+                  flags(0), score(0), foundationRegistry(0), seen(0), talonHash(0), tableauExact(0), tableauSum(0) {
+            cards.fill(NoCard);
+            rehash();
+        }
+
+        // full recompute of the keys; deal() uses it, and it's the reference the incremental updates must match
+        void rehash() {
+            talonHash = Zobrist::keys.cursor[wasteCount] ^ Zobrist::keys.flags[flags];
+            for (int pos = 0; pos < wasteSize(); ++pos) talonHash ^= Zobrist::keys.waste[wasteCard(pos)];
+            for (int pos = 0; pos < stockSize(); ++pos) talonHash ^= Zobrist::keys.stock[stockCard(pos)];
+            for (int f = 0; f < NO_OF_SUITS; ++f) {
+                for (int pos = 0; pos < foundationSize(f); ++pos) talonHash ^= Zobrist::keys.foundation[f][foundationCard(f, pos)];
+            }
+            tableauExact = 0;
+            tableauSum = 0;
+            for (int t = 0; t < NO_OF_TABLEAUS; ++t) {
+                const ColumnKeys keys = columnKeys(t);
+                tableauExact ^= keys.exact;
+                tableauSum += Zobrist::mix(keys.canonical);
+            }
+        }
+
+        std::uint64_t hash() const { return talonHash ^ tableauExact; }
+        // same position with the tableau columns in any order -> same key
+        std::uint64_t canonicalHash() const { return talonHash ^ tableauSum; }
+
+        int tableauSize(int idx) const { return lengths[idx]; }
+        Card tableauCard(int idx, int pos) const { return cards[pileStart(idx) + pos]; }
+        Card tableauTop(int idx) const { return lengths[idx] ? cards[pileStart(idx) + lengths[idx] - 1] : NoCard; }
+        int hiddenCount(int idx) const { return hidden[idx]; }
+        bool isFaceUp(int idx, int pos) const { return pos >= hidden[idx]; }
+
+        int foundationSize(int idx) const { return foundationTops[idx] == NoCard ? 0 : rankOf(foundationTops[idx]); }
+        Card foundationTop(int idx) const { return foundationTops[idx]; }
+        Card foundationCard(int idx, int pos) const { return makeCard(suitOf(foundationTops[idx]), pos + 1); }
+
+        // positions count from the bottom of the pile like the GUI piles; the stock's top is the next card drawn
+        int stockSize() const { return lengths[TALON] - wasteCount; }
+        Card stockCard(int pos) const { return cards[loose() - 1 - pos]; }
+        int wasteSize() const { return wasteCount; }
+        Card wasteCard(int pos) const { return cards[pileStart(TALON) + pos]; }
+        Card wasteTop() const { return wasteCount ? cards[pileStart(TALON) + wasteCount - 1] : NoCard; }
+
+        int getScore() const { return score; }
+        bool isStalled() const { return flags & FlagStalled; }
+        std::uint64_t getFoundationRegistry() const { return foundationRegistry; }
+        std::uint64_t seenCards() const { return seen; }
+        bool isSeen(Card card) const { return (seen >> card) & 1; }
+
+        int cardsOnFoundations() const { return NO_OF_CARDS - loose(); }
+        bool isWon() const { return loose() == 0; }
+    };
+
+    static_assert(std::is_trivially_copyable<State>::value, "State must stay memcpy-able");
+    static_assert(sizeof(State) <= 128, "State should stay within two cache lines");
+
+    // Deal number `seed` -> always the same game, on every platform (std::shuffle isn't specified well enough for that).
+    // Ordered deck, Fisher-Yates on a Philox stream keyed by the seed, then 1..7 cards per tableau off the top.
+    inline void deal(State& state, std::uint64_t seed) {
+        std::array<Card, NO_OF_CARDS> deck;
+        for (int i = 0; i < NO_OF_CARDS; ++i) deck[i] = static_cast<Card>(i);
+        Rng rng(seed);
+        for (int i = NO_OF_CARDS - 1; i > 0; --i) {
+            std::swap(deck[i], deck[rng.below(static_cast<std::uint32_t>(i + 1))]);
+        }
+
+        state = State();
+        int top = NO_OF_CARDS; // deck[top - 1] is the top of the undealt stock
+        int pos = 0;
+        for (int i = 0; i < NO_OF_TABLEAUS; ++i) {
+            for (int j = 0; j <= i; ++j) state.cards[pos++] = deck[--top];
+            state.lengths[i] = static_cast<std::uint8_t>(i + 1);
+            state.hidden[i] = static_cast<std::uint8_t>(i); // only the last card dealt is face up
+            state.seen |= std::uint64_t {1} << state.cards[pos - 1];
+        }
+        while (top > 0) state.cards[pos++] = deck[--top]; // talon front is the stock top
+        state.lengths[State::TALON] = static_cast<std::uint8_t>(NO_OF_CARDS - NO_OF_TABLEAUS * (NO_OF_TABLEAUS + 1) / 2);
+        state.rehash();
+    }
+
+    inline bool isLegal(const State& state, const Move& move) {
+        switch (move.kind) {
+        case MoveKind::Draw:
+            return state.stockSize() > 0 || state.wasteSize() > 0;
+        case MoveKind::WasteToTableau:
+            return state.wasteSize() > 0 && Rules::tableauCanStack(state.wasteTop(), state.tableauTop(move.to));
+        case MoveKind::WasteToFoundation:
+            return state.wasteSize() > 0 && Rules::foundationCanStack(state.wasteTop(), state.foundationTop(move.to));
+        case MoveKind::TableauToFoundation:
+            return state.tableauSize(move.from) > 0
+                && Rules::foundationCanStack(state.tableauTop(move.from), state.foundationTop(move.to));
+        case MoveKind::FoundationToTableau:
+            return state.foundationSize(move.from) > 0
+                && Rules::tableauCanStack(state.foundationTop(move.from), state.tableauTop(move.to));
+        case MoveKind::TableauToTableau: {
+            if (move.from == move.to || move.count == 0) return false;
+            const int size = state.tableauSize(move.from);
+            const int base = size - move.count;
+            if (base < state.hiddenCount(move.from)) return false; // only face-up runs can be dragged
+            return Rules::tableauCanStack(state.tableauCard(move.from, base), state.tableauTop(move.to));
+        }
+        }
+        return false;
+    }
+
+    // upper bound on legal moves in any position: draw, 7 waste->tableau, 4 waste->foundation,
+    // 7x4 tableau->foundation, 4x7 foundation->tableau and one run per ordered pair of tableaus
+    constexpr int MAX_LEGAL_MOVES = 1 + NO_OF_TABLEAUS + NO_OF_SUITS + 2 * NO_OF_TABLEAUS * NO_OF_SUITS
+                                  + NO_OF_TABLEAUS * (NO_OF_TABLEAUS - 1);
+
+    // fixed-capacity move buffer, lives on the stack so move generation never touches the heap
+    class MoveList {
+    private:
+        std::array<Move, MAX_LEGAL_MOVES> moves;
+        int count {0};
+
+    public:
+        void clear() { count = 0; }
+        void push(const Move& move) { moves[count++] = move; }
+        int size() const { return count; }
+        bool empty() const { return count == 0; }
+        const Move& operator[](int idx) const { return moves[idx]; }
+        const Move* begin() const { return moves.data(); }
+        const Move* end() const { return moves.data() + count; }
+    };
+
+    inline void legalMoves(const State& state, MoveList& moves) {
+        moves.clear();
+
+        std::array<Card, NO_OF_TABLEAUS> tops;
+        std::array<int, NO_OF_TABLEAUS> face_up;
+        for (int t = 0; t < NO_OF_TABLEAUS; ++t) {
+            tops[t] = state.tableauTop(t);
+            face_up[t] = state.tableauSize(t) - state.hiddenCount(t);
+        }
+        const Card waste_top = state.wasteTop();
+
+        for (int t = 0; t < NO_OF_TABLEAUS; ++t) {
+            if (tops[t] == NoCard) continue;
+            for (int f = 0; f < NO_OF_SUITS; ++f) {
+                if (Rules::foundationCanStack(tops[t], state.foundationTop(f))) {
+                    moves.push({MoveKind::TableauToFoundation, static_cast<std::uint8_t>(t), static_cast<std::uint8_t>(f), 1});
+                }
+            }
+        }
+        if (waste_top != NoCard) {
+            for (int f = 0; f < NO_OF_SUITS; ++f) {
+                if (Rules::foundationCanStack(waste_top, state.foundationTop(f))) {
+                    moves.push({MoveKind::WasteToFoundation, 0, static_cast<std::uint8_t>(f), 1});
+                }
+            }
+        }
+        // a face-up run always descends by one from its base, so for each target the only card that
+        // can go there is the one whose rank is one below the target's top (or the King for an empty tableau)
+        for (int from = 0; from < NO_OF_TABLEAUS; ++from) {
+            if (face_up[from] == 0) continue;
+            const int top_rank = rankOf(tops[from]);
+            const int base_rank = top_rank + face_up[from] - 1;
+            for (int to = 0; to < NO_OF_TABLEAUS; ++to) {
+                if (to == from) continue;
+                const int wanted = (tops[to] == NoCard) ? King : rankOf(tops[to]) - 1;
+                if (wanted < top_rank || wanted > base_rank) continue;
+                const int count = wanted - top_rank + 1;
+                const Card base = state.tableauCard(from, state.tableauSize(from) - count);
+                if (Rules::tableauCanStack(base, tops[to])) {
+                    moves.push({MoveKind::TableauToTableau, static_cast<std::uint8_t>(from), static_cast<std::uint8_t>(to),
+                                static_cast<std::uint8_t>(count)});
+                }
+            }
+        }
+        if (waste_top != NoCard) {
+            for (int t = 0; t < NO_OF_TABLEAUS; ++t) {
+                if (Rules::tableauCanStack(waste_top, tops[t])) {
+                    moves.push({MoveKind::WasteToTableau, 0, static_cast<std::uint8_t>(t), 1});
+                }
+            }
+        }
+        for (int f = 0; f < NO_OF_SUITS; ++f) {
+            const Card card = state.foundationTop(f);
+            if (card == NoCard) continue;
+            for (int t = 0; t < NO_OF_TABLEAUS; ++t) {
+                if (Rules::tableauCanStack(card, tops[t])) {
+                    moves.push({MoveKind::FoundationToTableau, static_cast<std::uint8_t>(f), static_cast<std::uint8_t>(t), 1});
+                }
+            }
+        }
+        if (state.stockSize() > 0 || state.wasteSize() > 0) moves.push({MoveKind::Draw, 0, 0, 1});
+    }
+
+    // Applies a move that isLegal() accepted; the hash keys follow along. The returned record carries the
+    // score delta and is all undo() needs to restore the position, so search can walk a tree in place.
+    inline Undo apply(State& state, const Move& move) {
+        const int score_before = state.score;
+        const auto& keys = Zobrist::keys;
+        Undo record {move, state.flags, false, false, false, 0, state.talonHash, state.tableauExact, state.tableauSum};
+
+        switch (move.kind) {
+        case MoveKind::Draw:
+            if (state.stockSize() > 0) {
+                const Card card = state.cards[state.pileStart(State::TALON) + state.wasteCount];
+                state.talonHash ^= keys.stock[card] ^ keys.waste[card]
+                                 ^ keys.cursor[state.wasteCount] ^ keys.cursor[state.wasteCount + 1];
+                state.wasteCount++; // the stock top is the card right after the waste, nothing moves
+                record.sighted = !state.isSeen(card);
+                state.seen |= std::uint64_t {1} << card;
+            } else { // recycle, same order as Operations::transferAllFromWasteToStock
+                for (int pos = 0; pos < state.wasteCount; ++pos) {
+                    const Card card = state.wasteCard(pos);
+                    state.talonHash ^= keys.waste[card] ^ keys.stock[card];
+                }
+                state.talonHash ^= keys.cursor[state.wasteCount] ^ keys.cursor[0];
+                if (!state.changeMadeInCycle()) state.setFlag(State::FlagStalled, true);
+                state.setFlag(State::FlagChangeMadeInCycle, false);
+                state.wasteCount = 0;
+                state.score += Score::CycleThroughStock;
+            }
+            break;
+        case MoveKind::WasteToTableau: {
+            const State::ColumnKeys before = state.columnKeys(move.to);
+            state.pushTableau(move.to, state.popWaste());
+            state.rehashColumn(move.to, before);
+            state.score += Score::CardDrawnFromStock;
+            state.setFlag(State::FlagChangeMadeInCycle, true);
+            break;
+        }
+        case MoveKind::WasteToFoundation:
+            record.registered = state.putOnFoundation(state.popWaste(), move.to);
+            state.score += Score::CardDrawnFromStock;
+            break;
+        case MoveKind::TableauToFoundation: {
+            const State::ColumnKeys before = state.columnKeys(move.from);
+            record.registered = state.putOnFoundation(state.popTableau(move.from), move.to);
+            record.revealed = state.revealTableauTop(move.from);
+            state.rehashColumn(move.from, before);
+            break;
+        }
+        case MoveKind::FoundationToTableau: {
+            const State::ColumnKeys before = state.columnKeys(move.to);
+            const Card card = state.foundationTops[move.from];
+            state.talonHash ^= keys.foundation[move.from][card];
+            state.foundationTops[move.from] = (rankOf(card) == Ace) ? NoCard : static_cast<Card>(card - 1);
+            state.pushTableau(move.to, card);
+            state.rehashColumn(move.to, before);
+            state.score += Score::CardDrawnFromFoundation;
+            break;
+        }
+        case MoveKind::TableauToTableau: {
+            const State::ColumnKeys before_from = state.columnKeys(move.from);
+            const State::ColumnKeys before_to = state.columnKeys(move.to);
+            const int src = state.pileStart(move.from) + state.lengths[move.from] - move.count;
+            const int dst = state.pileStart(move.to) + state.lengths[move.to];
+            state.relocate(src, move.count, dst);
+            state.lengths[move.from] -= move.count;
+            state.lengths[move.to] += move.count;
+            record.revealed = state.revealTableauTop(move.from);
+            state.rehashColumn(move.from, before_from);
+            state.rehashColumn(move.to, before_to);
+            break;
+        }
+        }
+
+        record.scoreDelta = state.score - score_before;
+        return record;
+    }
+
+    // Takes back the move apply() returned this record for; the state must not have changed since.
+    // Nothing is rehashed, the keys come back from the record.
+    inline void undo(State& state, const Undo& record) {
+        const Move& move = record.move;
+        auto put_back_on_waste = [&state](Card card) {
+            state.insertAt(state.pileStart(State::TALON) + state.wasteCount, card);
+            state.wasteCount++;
+            state.lengths[State::TALON]++;
+        };
+        // the card that the move had turned face up goes back to being unseen
+        auto hide_again = [&state](int idx) {
+            state.hidden[idx]++;
+            state.seen &= ~(std::uint64_t {1} << state.cards[state.pileStart(idx) + state.hidden[idx] - 1]);
+        };
+        auto take_off_foundation = [&state, &record](int idx) {
+            const Card card = state.foundationTops[idx];
+            state.foundationTops[idx] = (rankOf(card) == Ace) ? NoCard : static_cast<Card>(card - 1);
+            if (record.registered) state.foundationRegistry &= ~(std::uint64_t {1} << card);
+            return card;
+        };
+
+        switch (move.kind) {
+        case MoveKind::Draw:
+            // a draw always leaves a waste card; an empty waste means it was a recycle of a stock that was empty
+            if (state.wasteCount == 0) {
+                state.wasteCount = state.lengths[State::TALON];
+            } else {
+                if (record.sighted) state.seen &= ~(std::uint64_t {1} << state.wasteTop());
+                state.wasteCount--;
+            }
+            break;
+        case MoveKind::WasteToTableau:
+            put_back_on_waste(state.popTableau(move.to));
+            break;
+        case MoveKind::WasteToFoundation:
+            put_back_on_waste(take_off_foundation(move.to));
+            break;
+        case MoveKind::TableauToFoundation:
+            if (record.revealed) hide_again(move.from);
+            state.pushTableau(move.from, take_off_foundation(move.to));
+            break;
+        case MoveKind::FoundationToTableau:
+            state.foundationTops[move.from] = state.popTableau(move.to);
+            break;
+        case MoveKind::TableauToTableau: {
+            const int src = state.pileStart(move.to) + state.lengths[move.to] - move.count;
+            const int dst = state.pileStart(move.from) + state.lengths[move.from];
+            state.relocate(src, move.count, dst);
+            state.lengths[move.to] -= move.count;
+            state.lengths[move.from] += move.count;
+            if (record.revealed) hide_again(move.from);
+            break;
+        }
+        }
+
+        state.flags = record.flags;
+        state.score -= record.scoreDelta;
+        state.talonHash = record.talonHash;
+        state.tableauExact = record.tableauExact;
+        state.tableauSum = record.tableauSum;
+    }
+
+    // Replaces the true deal with one the player can't tell apart from it: the cards nobody has seen yet
+    // (face-down tableau cards and stock cards never drawn) are shuffled among those same slots, everything
+    // seen stays where it is. Fixed-size buffers only, and the keys are rebuilt for the new deal.
+    inline void determinize(State& state, Rng& rng) {
+        std::array<std::uint8_t, NO_OF_CARDS> slots;
+        std::array<Card, NO_OF_CARDS> unseen;
+        int n = 0;
+        for (int t = 0; t < NO_OF_TABLEAUS; ++t) {
+            const int start = state.pileStart(t);
+            for (int pos = 0; pos < state.hidden[t]; ++pos) slots[n++] = static_cast<std::uint8_t>(start + pos);
+        }
+        for (int pos = state.pileStart(State::TALON) + state.wasteCount; pos < state.loose(); ++pos) {
+            if (!state.isSeen(state.cards[pos])) slots[n++] = static_cast<std::uint8_t>(pos);
+        }
+        for (int i = 0; i < n; ++i) unseen[i] = state.cards[slots[i]];
+        for (int i = n - 1; i > 0; --i) std::swap(unseen[i], unseen[rng.below(static_cast<std::uint32_t>(i + 1))]);
+        for (int i = 0; i < n; ++i) state.cards[slots[i]] = unseen[i];
+        state.rehash();
+    }
+
+    inline bool hasLegalMove(const State& state) {
+        MoveList moves;
+        legalMoves(state, moves);
+        return !moves.empty();
+    }
+
+    // won, stalled on a stock cycle, or nothing left to do
+    inline bool isTerminal(const State& state) {
+        return state.isWon() || state.isStalled() || !hasLegalMove(state);
+    }
+}
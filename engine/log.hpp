@@ -0,0 +1,210 @@
+#pragma once
+
+// Leveled logging for hot paths. A LOG_* call under AISOL_LOG_LEVEL compiles to nothing (arguments included);
+// an enabled one formats into a slot of a lock-free ring and returns - no lock, no syscall, no flush. A
+// background thread drains the ring to stdout (Debug, Info) or stderr (Warn, Error), one flush per batch.
+// If the ring is full the message is dropped and counted, logging never blocks the caller.
+//   g++ ... -DAISOL_LOG_LEVEL=0   everything, including per-event Debug chatter
+//   (default 1)                   Info and up
+//   -DAISOL_LOG_LEVEL=4           nothing at all
+// Usage: LOG_INFO("Dealing game #", seed); arguments are concatenated, no separators added.
+
+#include <array>
+#include <atomic>
+#include <chrono>
+#include <cmath>
+#include <condition_variable>
+#include <cstdint>
+#include <cstdio>
+#include <cstring>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <type_traits>
+
+#ifndef AISOL_LOG_LEVEL
+#define AISOL_LOG_LEVEL 1
+#endif
+
+namespace Klondike {
+    namespace Log {
+
+        enum Level : int { Debug = 0, Info = 1, Warn = 2, Error = 3, Off = 4 };
+
+        constexpr int MessageBytes = 240;
+        constexpr std::uint64_t Capacity = 1024; // power of two
+
+        // Multi-producer single-consumer bounded ring (per-slot sequence numbers, Vyukov style).
+        class Logger {
+        private:
+            struct Slot {
+                std::atomic<std::uint64_t> sequence;
+                int level;
+                int length;
+                char text[MessageBytes];
+            };
+
+            std::array<Slot, Capacity> slots;
+            alignas(64) std::atomic<std::uint64_t> head {0}; // next slot to claim (producers)
+            alignas(64) std::atomic<std::uint64_t> tail {0}; // next slot to print (drainer)
+            std::atomic<std::uint64_t> dropped {0};
+
+            std::mutex sleepLock;
+            std::condition_variable wake;
+            std::atomic<bool> sleeping {false};
+            std::atomic<bool> stopping {false};
+            std::thread drainer;
+
+            static constexpr auto IdleWait = std::chrono::milliseconds(250); // also covers a missed wake-up
+
+            // prints everything published so far; returns how many messages that was
+            int drain() {
+                int printed = 0;
+                bool to_out = false, to_err = false;
+                for (;;) {
+                    const std::uint64_t at = tail.load(std::memory_order_relaxed);
+                    Slot& slot = slots[at & (Capacity - 1)];
+                    if (slot.sequence.load(std::memory_order_acquire) != at + 1) break;
+                    std::FILE* stream = slot.level >= Warn ? stderr : stdout;
+                    std::fwrite(slot.text, 1, slot.length, stream);
+                    std::fputc('\n', stream);
+                    (slot.level >= Warn ? to_err : to_out) = true;
+                    slot.sequence.store(at + Capacity, std::memory_order_release); // free for the next lap
+                    tail.store(at + 1, std::memory_order_release);
+                    ++printed;
+                }
+                const std::uint64_t lost = dropped.exchange(0, std::memory_order_relaxed);
+                if (lost) {
+                    std::fprintf(stderr, "[log] %llu messages dropped, ring full\n", static_cast<unsigned long long>(lost));
+                    to_err = true;
+                }
+                if (to_out) std::fflush(stdout);
+                if (to_err) std::fflush(stderr);
+                return printed;
+            }
+
+            void drainLoop() {
+                while (!stopping.load(std::memory_order_acquire)) {
+                    if (drain() > 0) continue;
+                    std::unique_lock<std::mutex> guard(sleepLock);
+                    sleeping.store(true);
+                    wake.wait_for(guard, IdleWait, [this] {
+                        return stopping.load() || slots[tail.load() & (Capacity - 1)].sequence.load() == tail.load() + 1;
+                    });
+                    sleeping.store(false);
+                }
+                drain();
+            }
+
+            static void append(char* text, int& length, const char* part, std::size_t bytes) {
+                const std::size_t room = MessageBytes - static_cast<std::size_t>(length);
+                if (bytes > room) bytes = room; // long messages are cut, not split
+                std::memcpy(text + length, part, bytes);
+                length += static_cast<int>(bytes);
+            }
+            static void append(char* text, int& length, const char* part) { append(text, length, part, std::strlen(part)); }
+            static void append(char* text, int& length, const std::string& part) { append(text, length, part.data(), part.size()); }
+            static void append(char* text, int& length, char part) { append(text, length, &part, 1); }
+            static void append(char* text, int& length, bool part) { append(text, length, part ? "true" : "false"); }
+            template <typename T, typename = std::enable_if_t<std::is_arithmetic<T>::value>>
+            static void append(char* text, int& length, T part) {
+                char digits[32];
+                int bytes;
+                if constexpr (std::is_floating_point<T>::value) {
+                    const double value = static_cast<double>(part); // %.3f would spell out every digit of 1e300
+                    bytes = std::snprintf(digits, sizeof(digits), std::fabs(value) < 1e15 ? "%.3f" : "%.6g", value);
+                } else if constexpr (std::is_signed<T>::value) bytes = std::snprintf(digits, sizeof(digits), "%lld", static_cast<long long>(part));
+                else bytes = std::snprintf(digits, sizeof(digits), "%llu", static_cast<unsigned long long>(part));
+                if (bytes < 0) bytes = 0;
+                if (bytes >= static_cast<int>(sizeof(digits))) bytes = sizeof(digits) - 1; // snprintf returns the untruncated length
+                append(text, length, digits, static_cast<std::size_t>(bytes));
+            }
+
+        public:
+            Logger() {
+                for (std::uint64_t i = 0; i < Capacity; ++i) slots[i].sequence.store(i, std::memory_order_relaxed);
+                drainer = std::thread(&Logger::drainLoop, this);
+            }
+            ~Logger() { shutdown(); }
+            Logger(const Logger&) = delete;
+            Logger& operator=(const Logger&) = delete;
+
+            template <typename... Args>
+            void write(int level, const Args&... args) {
+                std::uint64_t at = head.load(std::memory_order_relaxed);
+                Slot* slot;
+                for (;;) {
+                    slot = &slots[at & (Capacity - 1)];
+                    const std::uint64_t sequence = slot->sequence.load(std::memory_order_acquire);
+                    if (sequence == at) {
+                        if (head.compare_exchange_weak(at, at + 1, std::memory_order_relaxed)) break;
+                    } else if (sequence < at) { // a lap behind: full
+                        dropped.fetch_add(1, std::memory_order_relaxed);
+                        return;
+                    } else {
+                        at = head.load(std::memory_order_relaxed);
+                    }
+                }
+                slot->level = level;
+                slot->length = 0;
+                (append(slot->text, slot->length, args), ...);
+                slot->sequence.store(at + 1, std::memory_order_release);
+                if (sleeping.load(std::memory_order_relaxed)) wake.notify_one();
+            }
+
+            // waits until everything logged so far is printed, e.g. before reading from the console
+            void flush() {
+                const std::uint64_t target = head.load(std::memory_order_acquire);
+                while (tail.load(std::memory_order_acquire) < target && drainer.joinable()) {
+                    wake.notify_one();
+                    std::this_thread::yield();
+                }
+            }
+
+            void shutdown() { // prints what's left and stops the thread; later messages are dropped
+                if (!drainer.joinable()) return;
+                {
+                    std::lock_guard<std::mutex> guard(sleepLock);
+                    stopping.store(true, std::memory_order_release);
+                }
+                wake.notify_one();
+                drainer.join();
+            }
+        };
+
+        inline Logger& logger() {
+            static Logger instance;
+            return instance;
+        }
+
+        inline void flush() { logger().flush(); }
+        inline void shutdown() { logger().shutdown(); }
+
+        template <int MessageLevel, typename... Args>
+        inline void write(const Args&... args) {
+            if constexpr (MessageLevel >= AISOL_LOG_LEVEL) logger().write(MessageLevel, args...);
+        }
+    }
+}
+
+// macros rather than plain calls so that a disabled level doesn't even evaluate its arguments
+#if AISOL_LOG_LEVEL <= 0
+#define LOG_DEBUG(...) ::Klondike::Log::write<::Klondike::Log::Debug>(__VA_ARGS__)
+#else
+#define LOG_DEBUG(...) ((void)0)
+#endif
+#if AISOL_LOG_LEVEL <= 1
+#define LOG_INFO(...) ::Klondike::Log::write<::Klondike::Log::Info>(__VA_ARGS__)
+#else
+#define LOG_INFO(...) ((void)0)
+#endif
+#if AISOL_LOG_LEVEL <= 2
+#define LOG_WARN(...) ::Klondike::Log::write<::Klondike::Log::Warn>(__VA_ARGS__)
+#else
+#define LOG_WARN(...) ((void)0)
+#endif
+#if AISOL_LOG_LEVEL <= 3
+#define LOG_ERROR(...) ::Klondike::Log::write<::Klondike::Log::Error>(__VA_ARGS__)
+#else
+#define LOG_ERROR(...) ((void)0)
+#endif
@@ -0,0 +1,308 @@
+#pragma once
+
+// Monte Carlo Tree Search player over the engine rules (legalMoves()/apply(), so the same Rules:: and Score::
+// that Logic:: and Statistics use in the GUI).
+//  - root parallelism: `trees` independent trees grown from the same position, their root visits summed per action
+//  - leaf parallelism: every round picks `leafBatch` leaves per tree and runs their rollouts across the pool
+//  - virtual loss: a leaf waiting for its rollout counts as a lost visit on its path, so the rest of the batch
+//    spreads out instead of piling into the same line
+//  - nodes live in a per-tree arena sized once up front; after a real move the chosen subtree is copied into
+//    the tree's second arena and the two swap, so the statistics carry over without any allocation
+// A simulation is worth the score it gains from the position given to setRoot() (plus winBonus on a win),
+// scaled into [0, 1]; measuring from there rather than from the current root keeps reused values comparable.
+// Everything random comes from Rng(seed, simulation number), so results don't depend on the thread count.
+
+#include <algorithm>
+#include <array>
+#include <cmath>
+#include <cstdint>
+#include <vector>
+
+#include "klondike.hpp"
+#include "actions.hpp"
+#include "rng.hpp"
+#include "threadpool.hpp"
+
+namespace Klondike {
+
+    class Mcts {
+    public:
+        struct Config {
+            int simulations = 4000;   // per tree and per search()
+            int trees = 1;
+            int leafBatch = 16;       // leaves per tree per round
+            int rolloutDepth = 200;   // random play is cut off here, Klondike rollouts can shuffle cards forever
+            int maxNodes = 1 << 18;   // arena size per tree (two arenas per tree)
+            double exploration = 0.7;
+            double winBonus = 1.0;    // on top of the normalised score gain
+            int threads = 0;          // counts the calling thread, 0 uses every core
+            std::uint64_t seed = 0;
+        };
+
+        Mcts() : Mcts(Config {}) {}
+        explicit Mcts(const Config& config)
+            : config(config), trees(std::max(config.trees, 1)), pool(config.threads) {
+            for (Tree& tree : trees) {
+                tree.nodes.reserve(config.maxNodes);
+                tree.spare.reserve(config.maxNodes);
+                tree.from.reserve(config.maxNodes);
+            }
+            pending.reserve(static_cast<std::size_t>(trees.size()) * std::max(config.leafBatch, 1));
+            setRoot(State());
+        }
+
+        // starts over from this position, dropping every tree
+        void setRoot(const State& state) {
+            root = state;
+            baseScore = state.getScore();
+            for (Tree& tree : trees) resetTree(tree);
+        }
+        const State& rootState() const { return root; }
+
+        // restarts the rollout streams, so a search depends only on the root and this seed
+        void reseed(std::uint64_t seed) {
+            config.seed = seed;
+            simulations = 0;
+        }
+
+        // runs the configured number of simulations and returns the most visited move
+        // (a Draw on a position without legal moves, which isLegal() will turn down)
+        Move search() {
+            const int batch = std::max(config.leafBatch, 1);
+            for (int done = 0; done < config.simulations; done += batch) {
+                const int leaves = std::min(batch, config.simulations - done);
+                pending.clear();
+                for (int t = 0; t < static_cast<int>(trees.size()); ++t) {
+                    for (int i = 0; i < leaves; ++i) selectLeaf(t);
+                }
+                pool.parallelFor(0, static_cast<int>(pending.size()), 1, [this](int lo, int hi) {
+                    for (int i = lo; i < hi; ++i) rollout(pending[i]);
+                });
+                for (const Pending& leaf : pending) backpropagate(trees[leaf.tree], leaf.node, leaf.value);
+            }
+            return bestMove();
+        }
+
+        // root visit counts summed over the trees, indexed by action id (ACTION_COUNT entries); returns the total.
+        // Normalised, this is the improved policy target. value_sums, if given, gets the matching sums of values.
+        std::int64_t visitCounts(std::int32_t* counts, double* value_sums = nullptr) const {
+            std::fill(counts, counts + ACTION_COUNT, 0);
+            if (value_sums) std::fill(value_sums, value_sums + ACTION_COUNT, 0.0);
+            std::int64_t total = 0;
+            for (const Tree& tree : trees) {
+                const Node& node = tree.nodes[0];
+                for (int c = 0; c < node.childCount; ++c) {
+                    const Node& child = tree.nodes[node.firstChild + c];
+                    counts[actionOf(child.move)] += child.visits;
+                    if (value_sums) value_sums[actionOf(child.move)] += child.valueSum;
+                    total += child.visits;
+                }
+            }
+            return total;
+        }
+
+        Move bestMove() const {
+            std::int32_t counts[ACTION_COUNT];
+            visitCounts(counts);
+            const int best = static_cast<int>(std::max_element(counts, counts + ACTION_COUNT) - counts);
+            return counts[best] > 0 ? moveOf(best) : Move {MoveKind::Draw, 0, 0, 0};
+        }
+
+        // plays a real move: the root moves down and every tree keeps the statistics under that move
+        void advance(const Move& move) {
+            apply(root, move);
+            for (Tree& tree : trees) reuseSubtree(tree, move);
+        }
+
+        int nodeCount(int tree = 0) const { return static_cast<int>(trees[tree].nodes.size()); }
+
+    private:
+        struct Node {
+            Move move;                // move from the parent
+            std::int32_t parent;      // -1 at the root
+            std::int32_t firstChild;  // children sit next to each other in the arena
+            std::uint8_t childCount;
+            bool expanded;
+            bool terminal;
+            std::int32_t visits;
+            std::int32_t virtualLoss; // rollouts still in flight through this node
+            double valueSum;
+        };
+
+        struct Tree {
+            std::vector<Node> nodes; // nodes[0] is the root
+            std::vector<Node> spare; // the subtree kept by advance() is copied in here, then the two swap
+            std::vector<std::int32_t> from;
+        };
+
+        struct Pending {
+            State state;
+            int tree;
+            std::int32_t node;
+            std::uint64_t simulation;
+            double value;
+        };
+
+        Config config;
+        std::vector<Tree> trees;
+        ThreadPool pool;
+        State root;
+        int baseScore {0};
+        std::vector<Pending> pending;
+        std::uint64_t simulations {0}; // numbers the rollouts, and so their random streams
+
+        static Node makeNode(const Move& move, std::int32_t parent) {
+            return Node {move, parent, 0, 0, false, false, 0, 0, 0.0};
+        }
+
+        void resetTree(Tree& tree) {
+            tree.nodes.clear();
+            tree.nodes.push_back(makeNode(Move {MoveKind::Draw, 0, 0, 0}, -1));
+        }
+
+        // upper bound on what a game can score from any position, for scaling values into [0, 1]
+        static constexpr double MaxGain = NO_OF_CARDS * Score::CardPutOnFoundation
+                                        + (NO_OF_TABLEAUS * (NO_OF_TABLEAUS - 1) / 2) * Score::CardRevealedOnTableau
+                                        + (NO_OF_CARDS - NO_OF_TABLEAUS * (NO_OF_TABLEAUS + 1) / 2) * Score::CardDrawnFromStock;
+
+        double valueOf(const State& state) const {
+            const double gain = std::max(0, state.getScore() - baseScore) / MaxGain;
+            return (std::min(gain, 1.0) + (state.isWon() ? config.winBonus : 0.0)) / (1.0 + config.winBonus);
+        }
+
+        // false if the arena is full or there's nothing to play; the node then stays a leaf
+        bool expand(Tree& tree, std::int32_t idx, const State& state) {
+            Node& node = tree.nodes[idx];
+            node.expanded = true;
+            if (state.isWon() || state.isStalled()) {
+                node.terminal = true;
+                return false;
+            }
+            MoveList moves;
+            legalMoves(state, moves);
+            if (moves.empty()) {
+                node.terminal = true;
+                return false;
+            }
+            if (static_cast<int>(tree.nodes.size()) + moves.size() > config.maxNodes) {
+                node.expanded = false; // try again once advance() has freed room
+                return false;
+            }
+            node.firstChild = static_cast<std::int32_t>(tree.nodes.size());
+            node.childCount = static_cast<std::uint8_t>(moves.size());
+            for (const Move& move : moves) tree.nodes.push_back(makeNode(move, idx));
+            return true;
+        }
+
+        std::int32_t selectChild(const Tree& tree, const Node& node) const {
+            const double parent_visits = node.visits + node.virtualLoss;
+            const double log_parent = std::log(std::max(parent_visits, 1.0));
+            std::int32_t best = node.firstChild;
+            double best_score = -1.0;
+            for (int c = 0; c < node.childCount; ++c) {
+                const std::int32_t idx = node.firstChild + c;
+                const Node& child = tree.nodes[idx];
+                const int n = child.visits + child.virtualLoss;
+                if (n == 0) return idx; // every move gets a first look before anything is compared
+                // a virtual loss is a visit worth 0
+                const double score = child.valueSum / n + config.exploration * std::sqrt(log_parent / n);
+                if (score > best_score) {
+                    best_score = score;
+                    best = idx;
+                }
+            }
+            return best;
+        }
+
+        // walks down one tree from the root, expands where it stops and queues the leaf for a rollout
+        void selectLeaf(int t) {
+            Tree& tree = trees[t];
+            Pending leaf;
+            leaf.state = root;
+            leaf.tree = t;
+            leaf.simulation = simulations++;
+            leaf.value = 0.0;
+
+            std::int32_t idx = 0;
+            for (;;) {
+                tree.nodes[idx].virtualLoss++;
+                const Node& node = tree.nodes[idx];
+                if (node.terminal) break;
+                if (!node.expanded) {
+                    // a leaf is rolled out once before it grows children; the root always grows
+                    if ((node.visits == 0 && idx != 0) || !expand(tree, idx, leaf.state)) break;
+                }
+                idx = selectChild(tree, tree.nodes[idx]);
+                apply(leaf.state, tree.nodes[idx].move);
+            }
+            leaf.node = idx;
+            pending.push_back(leaf);
+        }
+
+        // uniformly random legal moves, except foundation -> tableau which random play only uses to undo progress
+        void rollout(Pending& leaf) const {
+            Rng rng(config.seed, leaf.simulation);
+            State& state = leaf.state;
+            MoveList moves;
+            std::array<Move, MAX_LEGAL_MOVES> picks;
+            for (int depth = 0; depth < config.rolloutDepth && !state.isWon() && !state.isStalled(); ++depth) {
+                legalMoves(state, moves);
+                int count = 0;
+                for (const Move& move : moves) {
+                    if (move.kind != MoveKind::FoundationToTableau) picks[count++] = move;
+                }
+                if (count == 0) { // nothing else left to try
+                    for (const Move& move : moves) picks[count++] = move;
+                }
+                if (count == 0) break;
+                apply(state, picks[rng.below(static_cast<std::uint32_t>(count))]);
+            }
+            leaf.value = valueOf(state);
+        }
+
+        static void backpropagate(Tree& tree, std::int32_t idx, double value) {
+            for (; idx >= 0; idx = tree.nodes[idx].parent) {
+                Node& node = tree.nodes[idx];
+                node.virtualLoss--;
+                node.visits++;
+                node.valueSum += value;
+            }
+        }
+
+        // copies the subtree under the root's child for `move` into the spare arena (breadth first, so children
+        // stay contiguous), then swaps arenas
+        void reuseSubtree(Tree& tree, const Move& move) {
+            const Node& old_root = tree.nodes[0];
+            std::int32_t kept = -1;
+            for (int c = 0; c < old_root.childCount; ++c) {
+                const Node& child = tree.nodes[old_root.firstChild + c];
+                if (child.move.kind == move.kind && child.move.from == move.from && child.move.to == move.to
+                    && child.move.count == move.count) {
+                    kept = old_root.firstChild + c;
+                }
+            }
+            if (kept < 0) {
+                resetTree(tree);
+                return;
+            }
+
+            tree.spare.clear();
+            tree.from.clear();
+            tree.spare.push_back(tree.nodes[kept]);
+            tree.spare[0].parent = -1;
+            tree.from.push_back(kept);
+            for (std::size_t i = 0; i < tree.spare.size(); ++i) {
+                const Node& source = tree.nodes[tree.from[i]];
+                if (source.childCount == 0) continue;
+                tree.spare[i].firstChild = static_cast<std::int32_t>(tree.spare.size());
+                for (int c = 0; c < source.childCount; ++c) {
+                    Node child = tree.nodes[source.firstChild + c];
+                    child.parent = static_cast<std::int32_t>(i);
+                    tree.spare.push_back(child);
+                    tree.from.push_back(source.firstChild + c);
+                }
+            }
+            std::swap(tree.nodes, tree.spare);
+        }
+    };
+}
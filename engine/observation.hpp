@@ -0,0 +1,98 @@
+#pragma once
+
+// Fixed-shape observation, written straight into a caller buffer as [OBS_CHANNELS, OBS_WIDTH].
+// Planes are indexed by card id (suit * 13 + rank - 1), so a column is one card:
+//   0..6   face-up in tableau t
+//   7      in the waste
+//   8      top of the waste (playable)
+//   9..12  on foundation f
+//   13     face up / visible at all (face-down tableau and stock cards stay 0 everywhere)
+//   14     depth in the waste counted from the top (top = 0), only set for waste cards
+//   15     globals, not per card: [0..6] face-down count per tableau, [7..13] tableau sizes,
+//          [14] stock size, [15] waste size (the stock/waste cursor), [16..19] foundation heights,
+//          [20] cards on foundations
+// Works for std::uint8_t and float buffers; values are the same small integers in both.
+
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+
+#include "klondike.hpp"
+
+namespace Klondike {
+
+    namespace Obs {
+        constexpr int Tableau = 0;
+        constexpr int Waste = Tableau + NO_OF_TABLEAUS;
+        constexpr int WasteTop = Waste + 1;
+        constexpr int Foundation = WasteTop + 1;
+        constexpr int FaceUp = Foundation + NO_OF_SUITS;
+        constexpr int WasteDepth = FaceUp + 1;
+        constexpr int Globals = WasteDepth + 1;
+        constexpr int Channels = Globals + 1;
+
+        // slots inside the Globals plane
+        constexpr int HiddenCounts = 0;
+        constexpr int TableauSizes = HiddenCounts + NO_OF_TABLEAUS;
+        constexpr int StockSize = TableauSizes + NO_OF_TABLEAUS;
+        constexpr int WasteSize = StockSize + 1;
+        constexpr int FoundationHeights = WasteSize + 1;
+        constexpr int CardsOnFoundations = FoundationHeights + NO_OF_SUITS;
+    }
+
+    constexpr int OBS_CHANNELS = Obs::Channels;
+    constexpr int OBS_WIDTH = NO_OF_CARDS;
+    constexpr int OBS_SIZE = OBS_CHANNELS * OBS_WIDTH;
+
+    template <typename T>
+    inline void encodeObservation(const State& state, T* out) {
+        std::fill(out, out + OBS_SIZE, T(0));
+        auto plane = [out](int channel) { return out + channel * OBS_WIDTH; };
+        T* face_up = plane(Obs::FaceUp);
+        T* globals = plane(Obs::Globals);
+
+        for (int t = 0; t < NO_OF_TABLEAUS; ++t) {
+            T* tableau = plane(Obs::Tableau + t);
+            const int size = state.tableauSize(t);
+            for (int pos = state.hiddenCount(t); pos < size; ++pos) {
+                const Card card = state.tableauCard(t, pos);
+                tableau[card] = T(1);
+                face_up[card] = T(1);
+            }
+            globals[Obs::HiddenCounts + t] = static_cast<T>(state.hiddenCount(t));
+            globals[Obs::TableauSizes + t] = static_cast<T>(size);
+        }
+
+        T* waste = plane(Obs::Waste);
+        T* depth = plane(Obs::WasteDepth);
+        const int waste_size = state.wasteSize();
+        for (int pos = 0; pos < waste_size; ++pos) {
+            const Card card = state.wasteCard(pos);
+            waste[card] = T(1);
+            face_up[card] = T(1);
+            depth[card] = static_cast<T>(waste_size - 1 - pos);
+        }
+        if (waste_size > 0) plane(Obs::WasteTop)[state.wasteTop()] = T(1);
+
+        for (int f = 0; f < NO_OF_SUITS; ++f) {
+            T* foundation = plane(Obs::Foundation + f);
+            const int height = state.foundationSize(f);
+            for (int pos = 0; pos < height; ++pos) {
+                const Card card = state.foundationCard(f, pos);
+                foundation[card] = T(1);
+                face_up[card] = T(1);
+            }
+            globals[Obs::FoundationHeights + f] = static_cast<T>(height);
+        }
+
+        globals[Obs::StockSize] = static_cast<T>(state.stockSize());
+        globals[Obs::WasteSize] = static_cast<T>(waste_size);
+        globals[Obs::CardsOnFoundations] = static_cast<T>(state.cardsOnFoundations());
+    }
+
+    // fills an [n, OBS_CHANNELS, OBS_WIDTH] slab in one pass over the states
+    template <typename T>
+    inline void encodeObservations(const State* states, int n, T* out) {
+        for (int i = 0; i < n; ++i) encodeObservation(states[i], out + static_cast<std::size_t>(i) * OBS_SIZE);
+    }
+}
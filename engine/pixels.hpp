@@ -0,0 +1,256 @@
+#pragma once
+
+// Headless pixel observations for agents that learn from pixels: draws a State into a small CPU buffer
+// (84x84, 128x128...) with no window, no GPU and no SDL. The board is laid out like the GUI (the same
+// proportions as DeckFormulae in solitaire.cpp, scaled to the frame).
+// Sprites come from the asset pack (engine/assetpack.hpp): an entry baked at the exact card size
+// ("...png@WxH", tools/pack.cpp --scale) is used as is, else the full-size image (or, in a pack without
+// one, the largest baked size) is area-averaged down once at construction. Alpha is cut to on/off then, so drawing a frame is only row copies: a memcpy for the
+// background, then an SSE2 masked copy (4 pixels per step) for each card row.
+// One renderer per thread; render() reuses its buffers, nothing is allocated per frame.
+
+#include <algorithm>
+#include <array>
+#include <cstdint>
+#include <cstring>
+#include <iostream>
+#include <string>
+#include <vector>
+
+#if defined(__SSE2__) || defined(_M_X64)
+#include <emmintrin.h>
+#define KLONDIKE_PIXELS_SSE2 1
+#endif
+
+#include "klondike.hpp"
+#include "assetpack.hpp"
+
+namespace Klondike {
+
+    // the asset path the GUI loads for a card, which is also its name in the pack
+    inline std::string cardAssetPath(Card card) {
+        static const char* const suits[NO_OF_SUITS] = {"red/Hearts_", "red/Tiles_", "black/Clovers_", "black/Pikes_"};
+        static const char* const ranks[SUIT_LENGTH] = {"A", "2", "3", "4", "5", "6", "7", "8", "9", "10", "Jack", "Queen", "King"};
+        return std::string("assets/cards/") + suits[static_cast<int>(suitOf(card))] + ranks[rankOf(card) - 1] + ".png";
+    }
+
+    class PixelRenderer {
+    public:
+        enum class Format { Rgb, Gray, Rgba };
+
+        struct Config {
+            int width = 84;
+            int height = 84;
+            Format format = Format::Rgb;
+            std::string pack = "assets/assets.pack";
+        };
+
+        PixelRenderer() : PixelRenderer(Config {}) {}
+        explicit PixelRenderer(const Config& config)
+            : config(config), width(std::max(config.width, 16)), height(std::max(config.height, 16)) {
+            computeLayout();
+            frame.resize(static_cast<std::size_t>(width) * height);
+            output.resize(frameBytes());
+            ready = loadSprites();
+        }
+
+        // false if the pack couldn't be opened or lacks an image; render() then only draws the background
+        bool ok() const { return ready; }
+
+        int frameWidth() const { return width; }
+        int frameHeight() const { return height; }
+        int channels() const { return config.format == Format::Gray ? 1 : config.format == Format::Rgb ? 3 : 4; }
+        std::size_t frameBytes() const { return static_cast<std::size_t>(width) * height * channels(); }
+
+        // row-major, channels() bytes per pixel (R, G, B[, A] or luma); valid until the next render()
+        const std::uint8_t* render(const State& state) {
+            std::memcpy(frame.data(), background.data(), frame.size() * sizeof(std::uint32_t));
+
+            drawSprite(state.stockSize() ? BackSprite : EmptySprite, stockX, topY);
+            drawSprite(state.wasteTop() != NoCard ? state.wasteTop() : EmptySprite, wasteX, topY);
+            for (int f = 0; f < NO_OF_SUITS; ++f) {
+                const Card top = state.foundationTop(f);
+                drawSprite(top != NoCard ? top : EmptySprite, foundationX[f], topY);
+            }
+            for (int t = 0; t < NO_OF_TABLEAUS; ++t) {
+                const int size = state.tableauSize(t);
+                if (size == 0) drawSprite(EmptySprite, tableauX[t], tableauY);
+                for (int pos = 0; pos < size; ++pos) {
+                    drawSprite(state.isFaceUp(t, pos) ? state.tableauCard(t, pos) : BackSprite, tableauX[t], tableauY + pos * tableauOffset);
+                }
+            }
+            return convert();
+        }
+
+    private:
+        static constexpr int BackSprite = NO_OF_CARDS;
+        static constexpr int EmptySprite = NO_OF_CARDS + 1;
+        static constexpr int Sprites = NO_OF_CARDS + 2;
+        static constexpr std::uint32_t Felt = 0xFF2A6A35; // RGBA bytes 35 6A 2A FF, when the pack has no background
+
+        Config config;
+        int width, height;
+        int cardW {0}, cardH {0}, tableauOffset {0};
+        int stockX {0}, wasteX {0}, topY {0}, tableauY {0};
+        std::array<int, NO_OF_SUITS> foundationX {};
+        std::array<int, NO_OF_TABLEAUS> tableauX {};
+
+        // pixels are RGBA bytes read as little-endian uint32, so alpha is the top byte
+        std::array<std::vector<std::uint32_t>, Sprites> sprites;
+        std::vector<std::uint32_t> background;
+        std::vector<std::uint32_t> frame;
+        std::vector<std::uint8_t> output;
+        bool ready {false};
+
+        // DeckFormulae at this frame size (the 20 px gaps are for a 1200 px wide window)
+        void computeLayout() {
+            cardW = std::max(width / 10, 1);
+            cardH = std::max(height * 2 / 13, 1);
+            tableauOffset = std::max(cardH / 4, 1);
+            const int gap = std::max(width * 20 / 1200, 1);
+            for (int t = 0; t < NO_OF_TABLEAUS; ++t) tableauX[t] = (width / 7) * t + cardW / 4;
+            tableauY = height / 4;
+            for (int f = 0; f < NO_OF_SUITS; ++f) foundationX[f] = width - (NO_OF_SUITS - f) * (cardW + gap);
+            topY = height / 15;
+            stockX = width / 20;
+            wasteX = stockX + cardW + gap;
+        }
+
+        // area average (alpha weighted) of a full-size image down to w x h; alpha ends up 0 or 255
+        static void downscale(const Pack::Reader& pack, const Pack::Entry& entry, int w, int h, std::vector<std::uint32_t>& out) {
+            out.assign(static_cast<std::size_t>(w) * h, 0);
+            const std::uint8_t* pixels = pack.pixels(entry);
+            for (int y = 0; y < h; ++y) {
+                const int y0 = static_cast<int>(static_cast<std::uint64_t>(y) * entry.height / h);
+                const int y1 = std::max(static_cast<int>(static_cast<std::uint64_t>(y + 1) * entry.height / h), y0 + 1);
+                for (int x = 0; x < w; ++x) {
+                    const int x0 = static_cast<int>(static_cast<std::uint64_t>(x) * entry.width / w);
+                    const int x1 = std::max(static_cast<int>(static_cast<std::uint64_t>(x + 1) * entry.width / w), x0 + 1);
+                    std::uint64_t r = 0, g = 0, b = 0, a = 0;
+                    for (int sy = y0; sy < y1; ++sy) {
+                        const std::uint8_t* row = pixels + static_cast<std::size_t>(sy) * entry.pitch;
+                        for (int sx = x0; sx < x1; ++sx) {
+                            const std::uint8_t* p = row + sx * 4;
+                            r += p[0] * p[3];
+                            g += p[1] * p[3];
+                            b += p[2] * p[3];
+                            a += p[3];
+                        }
+                    }
+                    const std::uint64_t n = static_cast<std::uint64_t>(y1 - y0) * (x1 - x0);
+                    if (a * 2 < n * 255) continue; // mostly transparent: stays a hole
+                    out[static_cast<std::size_t>(y) * w + x] = static_cast<std::uint32_t>(r / a) | static_cast<std::uint32_t>(g / a) << 8
+                                                             | static_cast<std::uint32_t>(b / a) << 16 | 0xFF000000u;
+                }
+            }
+        }
+
+        // an exact-size entry straight from the pack, alpha cut the same way
+        static void copyExact(const Pack::Reader& pack, const Pack::Entry& entry, std::vector<std::uint32_t>& out) {
+            out.resize(static_cast<std::size_t>(entry.width) * entry.height);
+            for (std::uint32_t y = 0; y < entry.height; ++y) {
+                std::memcpy(&out[static_cast<std::size_t>(y) * entry.width], pack.pixels(entry) + static_cast<std::size_t>(y) * entry.pitch, entry.width * 4);
+            }
+            for (std::uint32_t& pixel : out) pixel = (pixel >> 31) ? (pixel | 0xFF000000u) : 0;
+        }
+
+        // packs baked with --scale only hold the card images at the baked sizes
+        static const Pack::Entry* largestScaled(const Pack::Reader& pack, const std::string& name) {
+            const std::string prefix = name + "@";
+            const Pack::Entry* best = nullptr;
+            for (int i = 0; i < pack.count(); ++i) {
+                const Pack::Entry& e = pack.entry(i);
+                if (std::strncmp(e.name, prefix.c_str(), prefix.size()) != 0) continue;
+                if (!best || static_cast<std::uint64_t>(e.width) * e.height > static_cast<std::uint64_t>(best->width) * best->height) best = &e;
+            }
+            return best;
+        }
+
+        bool loadImage(const Pack::Reader& pack, const std::string& name, int w, int h, std::vector<std::uint32_t>& out) {
+            if (const Pack::Entry* exact = pack.find(Pack::scaledName(name, w, h))) {
+                if (static_cast<int>(exact->width) == w && static_cast<int>(exact->height) == h) {
+                    copyExact(pack, *exact, out);
+                    return true;
+                }
+            }
+            const Pack::Entry* full = pack.find(name);
+            if (!full) full = largestScaled(pack, name);
+            if (!full) {
+                std::cerr<<"Asset pack "<<config.pack<<" has no "<<name<<std::endl;
+                return false;
+            }
+            downscale(pack, *full, w, h, out);
+            return true;
+        }
+
+        bool loadSprites() {
+            background.assign(frame.size(), Felt);
+            Pack::Reader pack;
+            if (!pack.open(config.pack)) {
+                std::cerr<<"Can't open asset pack "<<config.pack<<" (build it with tools/pack.cpp)"<<std::endl;
+                return false;
+            }
+            bool complete = true;
+            for (Card card = 0; card < NO_OF_CARDS; ++card) complete = loadImage(pack, cardAssetPath(card), cardW, cardH, sprites[card]) && complete;
+            complete = loadImage(pack, "assets/cards/back.png", cardW, cardH, sprites[BackSprite]) && complete;
+            complete = loadImage(pack, "assets/cards/empty.png", cardW, cardH, sprites[EmptySprite]) && complete;
+            if (pack.find("assets/woodsplash.png")) {
+                loadImage(pack, "assets/woodsplash.png", width, height, background);
+                for (std::uint32_t& pixel : background) pixel |= 0xFF000000u; // opaque, the holes were fully transparent anyway
+            }
+            if (!complete) {
+                for (auto& sprite : sprites) sprite.clear();
+            }
+            return complete; // the sprites are copies, the mapping goes away here
+        }
+
+        // opaque source pixels replace the destination, transparent ones leave it
+        static void copyRow(std::uint32_t* dst, const std::uint32_t* src, int n) {
+            int i = 0;
+#ifdef KLONDIKE_PIXELS_SSE2
+            for (; i + 4 <= n; i += 4) {
+                const __m128i s = _mm_loadu_si128(reinterpret_cast<const __m128i*>(src + i));
+                const __m128i d = _mm_loadu_si128(reinterpret_cast<const __m128i*>(dst + i));
+                const __m128i opaque = _mm_srai_epi32(s, 31); // alpha is 0 or 255, its top bit is the mask
+                _mm_storeu_si128(reinterpret_cast<__m128i*>(dst + i), _mm_or_si128(_mm_and_si128(opaque, s), _mm_andnot_si128(opaque, d)));
+            }
+#endif
+            for (; i < n; ++i) {
+                if (src[i] >> 31) dst[i] = src[i];
+            }
+        }
+
+        void drawSprite(int sprite, int x, int y) {
+            const std::vector<std::uint32_t>& pixels = sprites[sprite];
+            if (pixels.empty()) return;
+            const int x0 = std::max(x, 0), x1 = std::min(x + cardW, width);
+            const int y0 = std::max(y, 0), y1 = std::min(y + cardH, height);
+            for (int row = y0; row < y1; ++row) {
+                copyRow(&frame[static_cast<std::size_t>(row) * width + x0], &pixels[static_cast<std::size_t>(row - y) * cardW + (x0 - x)], x1 - x0);
+            }
+        }
+
+        const std::uint8_t* convert() {
+            const std::uint8_t* rgba = reinterpret_cast<const std::uint8_t*>(frame.data());
+            const std::size_t count = frame.size();
+            switch (config.format) {
+            case Format::Rgba:
+                std::memcpy(output.data(), rgba, count * 4);
+                break;
+            case Format::Rgb:
+                for (std::size_t i = 0; i < count; ++i) {
+                    output[i * 3] = rgba[i * 4];
+                    output[i * 3 + 1] = rgba[i * 4 + 1];
+                    output[i * 3 + 2] = rgba[i * 4 + 2];
+                }
+                break;
+            case Format::Gray: // BT.601 luma in 8.8 fixed point
+                for (std::size_t i = 0; i < count; ++i) {
+                    output[i] = static_cast<std::uint8_t>((77 * rgba[i * 4] + 150 * rgba[i * 4 + 1] + 29 * rgba[i * 4 + 2]) >> 8);
+                }
+                break;
+            }
+            return output.data();
+        }
+    };
+}
@@ -0,0 +1,73 @@
+#pragma once
+
+// Counter-based random numbers (Philox4x32-10). The output is a pure function of (key, stream, position),
+// so every env in a batch gets its own independent stream and a run replays exactly no matter which
+// thread stepped which env. Trivially copyable, no heap, no global state.
+
+#include <array>
+#include <cstdint>
+
+namespace Klondike {
+
+    class Rng {
+    private:
+        std::array<std::uint32_t, 2> key;
+        std::uint64_t stream;
+        std::uint64_t position {0}; // index of the next block
+        std::array<std::uint32_t, 4> block {};
+        int used {4};               // words of block already handed out
+
+        static constexpr std::uint32_t M0 = 0xD2511F53, M1 = 0xCD9E8D57;
+        static constexpr std::uint32_t W0 = 0x9E3779B9, W1 = 0xBB67AE85;
+
+        void refill() {
+            std::array<std::uint32_t, 4> ctr = {static_cast<std::uint32_t>(position), static_cast<std::uint32_t>(position >> 32),
+                                                static_cast<std::uint32_t>(stream), static_cast<std::uint32_t>(stream >> 32)};
+            std::uint32_t k0 = key[0], k1 = key[1];
+            for (int round = 0; round < 10; ++round) {
+                const std::uint64_t p0 = static_cast<std::uint64_t>(M0) * ctr[0];
+                const std::uint64_t p1 = static_cast<std::uint64_t>(M1) * ctr[2];
+                ctr = {static_cast<std::uint32_t>(p1 >> 32) ^ ctr[1] ^ k0, static_cast<std::uint32_t>(p1),
+                       static_cast<std::uint32_t>(p0 >> 32) ^ ctr[3] ^ k1, static_cast<std::uint32_t>(p0)};
+                k0 += W0;
+                k1 += W1;
+            }
+            block = ctr;
+            position++;
+            used = 0;
+        }
+
+    public:
+        explicit Rng(std::uint64_t seed = 0, std::uint64_t stream_id = 0)
+            : key {static_cast<std::uint32_t>(seed), static_cast<std::uint32_t>(seed >> 32)}, stream(stream_id) {}
+
+        std::uint32_t next32() {
+            if (used == 4) refill();
+            return block[used++];
+        }
+        std::uint64_t next64() {
+            const std::uint64_t lo = next32();
+            return (static_cast<std::uint64_t>(next32()) << 32) | lo;
+        }
+
+        // uniform in [0, bound), unbiased (Lemire's multiply-and-reject)
+        std::uint32_t below(std::uint32_t bound) {
+            std::uint64_t m = static_cast<std::uint64_t>(next32()) * bound;
+            std::uint32_t low = static_cast<std::uint32_t>(m);
+            if (low < bound) {
+                const std::uint32_t threshold = static_cast<std::uint32_t>(-bound) % bound;
+                while (low < threshold) {
+                    m = static_cast<std::uint64_t>(next32()) * bound;
+                    low = static_cast<std::uint32_t>(m);
+                }
+            }
+            return static_cast<std::uint32_t>(m >> 32);
+        }
+
+        // jump straight to the n-th block of this stream
+        void seek(std::uint64_t block_index) {
+            position = block_index;
+            used = 4;
+        }
+    };
+}
@@ -0,0 +1,230 @@
+#pragma once
+
+// Shared-memory protocol between `solitaire --serve NAME` (envserver.hpp) and an out-of-process trainer.
+// One POSIX shm segment /NAME holds a Header followed by a ring of slots. A slot is a whole batch request
+// (command, actions or deal seeds) plus the batch results (rewards, dones, final scores, masks, observations),
+// all at fixed offsets, so nothing is serialised and a trainer can wrap the arrays as tensors in place.
+//
+// The trainer fills slot (seq % slots), then bumps `submitted`; the server runs slots in order and bumps
+// `completed` when a slot's outputs are ready. Both counters are futex words, each side spins for a moment
+// and then sleeps in the kernel until the other one wakes it. Linux only.
+// The header records the server's pid, so a segment whose server died without unlinking it can be told from
+// a live one (pids are only meaningful within one pid namespace, run both sides in the same container).
+// Any language can speak it: read the Header fields, mmap the segment, follow the offsets.
+
+#include <atomic>
+#include <cerrno>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <ctime>
+#include <string>
+
+#include <fcntl.h>
+#include <linux/futex.h>
+#include <signal.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+
+#include "actions.hpp"
+#include "observation.hpp"
+
+namespace Klondike {
+    namespace Shm {
+
+        constexpr std::uint32_t Magic = 0x4B4C5356; // "KLSV"
+        constexpr std::uint32_t Version = 1;
+
+        enum Command : std::uint32_t {
+            Step = 1,       // actions[] (action ids) -> every output
+            Reset = 2,      // fresh deals from the env streams, reseeded with `seed` when it isn't 0 -> masks, obs
+            ResetSeeds = 3, // exact deals from seeds[] -> masks, obs
+            Shutdown = 4    // server unmaps, unlinks the segment and exits
+        };
+
+        static_assert(std::atomic<std::uint32_t>::is_always_lock_free, "futex words must be plain 32-bit words");
+
+        // offsets are in bytes from the start of the segment (header fields) or of the slot (slot fields)
+        struct Header {
+            std::uint32_t magic;
+            std::uint32_t version;
+            std::uint32_t envs;
+            std::uint32_t slots;
+            std::uint32_t obsChannels;
+            std::uint32_t obsWidth;
+            std::uint32_t actionCount;
+            std::uint32_t maskWords;
+            std::uint32_t serverPid;
+            std::uint32_t reserved;
+            std::uint64_t segmentBytes;
+            std::uint64_t firstSlot;
+            std::uint64_t slotBytes;
+            // inside a slot, each array has one entry (or row) per env
+            std::uint64_t actions;     // int32
+            std::uint64_t seeds;       // uint64, ResetSeeds only
+            std::uint64_t rewards;     // float32
+            std::uint64_t dones;       // uint8
+            std::uint64_t finalScores; // int32
+            std::uint64_t masks;       // uint8 [actionCount]
+            std::uint64_t maskBits;    // uint64 [maskWords]
+            std::uint64_t obs;         // uint8 [obsChannels * obsWidth]
+
+            alignas(64) std::atomic<std::uint32_t> submitted; // written by the trainer
+            alignas(64) std::atomic<std::uint32_t> completed; // written by the server
+            alignas(64) std::atomic<std::uint32_t> serverReady;
+        };
+
+        struct SlotHeader {
+            std::uint32_t command;
+            std::uint32_t reserved;
+            std::uint64_t seed; // Reset only
+        };
+
+        constexpr std::uint64_t alignUp(std::uint64_t bytes) { return (bytes + 63) & ~std::uint64_t {63}; }
+
+        // fills in every size and offset for a segment of `envs` envs and `slots` slots
+        inline void describe(Header& header, std::uint32_t envs, std::uint32_t slots) {
+            header.magic = Magic;
+            header.version = Version;
+            header.envs = envs;
+            header.slots = slots;
+            header.obsChannels = OBS_CHANNELS;
+            header.obsWidth = OBS_WIDTH;
+            header.actionCount = ACTION_COUNT;
+            header.maskWords = ACTION_MASK_WORDS;
+
+            std::uint64_t at = alignUp(sizeof(SlotHeader));
+            auto place = [&at, envs](std::uint64_t bytes_per_env) {
+                const std::uint64_t offset = at;
+                at = alignUp(at + bytes_per_env * envs);
+                return offset;
+            };
+            header.actions = place(sizeof(std::int32_t));
+            header.seeds = place(sizeof(std::uint64_t));
+            header.rewards = place(sizeof(float));
+            header.dones = place(sizeof(std::uint8_t));
+            header.finalScores = place(sizeof(std::int32_t));
+            header.masks = place(ACTION_COUNT);
+            header.maskBits = place(ACTION_MASK_WORDS * sizeof(std::uint64_t));
+            header.obs = place(OBS_SIZE);
+            header.slotBytes = at;
+            header.firstSlot = alignUp(sizeof(Header));
+            header.segmentBytes = header.firstSlot + header.slotBytes * slots;
+        }
+
+        inline std::uint8_t* slotAt(Header* header, std::uint32_t seq) {
+            return reinterpret_cast<std::uint8_t*>(header) + header->firstSlot + header->slotBytes * (seq % header->slots);
+        }
+
+        // shared (not FUTEX_PRIVATE) futex calls, the two sides are different processes; timeout_ms < 0 waits for good
+        inline void futexWait(std::atomic<std::uint32_t>& word, std::uint32_t expected, int timeout_ms = -1) {
+            timespec timeout {timeout_ms / 1000, (timeout_ms % 1000) * 1000000L};
+            syscall(SYS_futex, reinterpret_cast<std::uint32_t*>(&word), FUTEX_WAIT, expected, timeout_ms < 0 ? nullptr : &timeout, nullptr, 0);
+        }
+        inline void futexWake(std::atomic<std::uint32_t>& word) {
+            syscall(SYS_futex, reinterpret_cast<std::uint32_t*>(&word), FUTEX_WAKE, INT32_MAX, nullptr, nullptr, 0);
+        }
+
+        constexpr int SpinsBeforeWait = 2048;
+
+        // EPERM means it exists but belongs to someone else
+        inline bool processAlive(std::uint32_t pid) {
+            return pid != 0 && (kill(static_cast<pid_t>(pid), 0) == 0 || errno == EPERM);
+        }
+
+        // blocks until word != value
+        inline void waitWhileEqual(std::atomic<std::uint32_t>& word, std::uint32_t value) {
+            for (int spin = 0; spin < SpinsBeforeWait; ++spin) {
+                if (word.load(std::memory_order_acquire) != value) return;
+            }
+            while (word.load(std::memory_order_acquire) == value) futexWait(word, value);
+        }
+
+        // Trainer side, for C++ trainers (and as the reference for other languages).
+        class Client {
+        private:
+            Header* header {nullptr};
+            std::size_t mapped {0};
+            std::uint32_t next {0}; // sequence number of the next slot to submit
+
+            static constexpr int ReadyPollMs = 50;
+
+        public:
+            Client() = default;
+            ~Client() { close(); }
+            Client(const Client&) = delete;
+            Client& operator=(const Client&) = delete;
+
+            // Maps /name, waiting up to timeout_ms for the server to finish setting it up. False if it doesn't
+            // exist, doesn't match, never becomes ready, or was left behind by a server that is gone.
+            bool open(const std::string& name, int timeout_ms = 5000) {
+                const int fd = shm_open(("/" + name).c_str(), O_RDWR, 0);
+                if (fd < 0) return false;
+                struct stat info;
+                if (fstat(fd, &info) != 0 || info.st_size < static_cast<off_t>(sizeof(Header))) {
+                    ::close(fd);
+                    return false;
+                }
+                void* mem = mmap(nullptr, info.st_size, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+                ::close(fd);
+                if (mem == MAP_FAILED) return false;
+                header = static_cast<Header*>(mem);
+                mapped = static_cast<std::size_t>(info.st_size);
+                for (int waited = 0; header->serverReady.load(std::memory_order_acquire) == 0; waited += ReadyPollMs) {
+                    if (waited >= timeout_ms) {
+                        close();
+                        return false;
+                    }
+                    futexWait(header->serverReady, 0, ReadyPollMs);
+                }
+                if (header->magic != Magic || header->version != Version
+                    || header->segmentBytes != static_cast<std::uint64_t>(info.st_size) || !processAlive(header->serverPid)) {
+                    close();
+                    return false;
+                }
+                next = header->submitted.load(std::memory_order_acquire);
+                return true;
+            }
+
+            void close() {
+                if (header) munmap(header, mapped);
+                header = nullptr;
+                mapped = 0;
+            }
+
+            const Header& layout() const { return *header; }
+
+            // the slot the next submit() sends; blocks while the ring is full
+            std::uint8_t* nextSlot() {
+                while (next - header->completed.load(std::memory_order_acquire) >= header->slots) {
+                    waitWhileEqual(header->completed, header->completed.load(std::memory_order_acquire));
+                }
+                return slotAt(header, next);
+            }
+            template <typename T>
+            T* field(std::uint8_t* slot, std::uint64_t offset) const { return reinterpret_cast<T*>(slot + offset); }
+
+            // sends nextSlot() with this command, returns its sequence number
+            std::uint32_t submit(Command command, std::uint64_t seed = 0) {
+                std::uint8_t* slot = nextSlot();
+                SlotHeader* request = reinterpret_cast<SlotHeader*>(slot);
+                request->command = command;
+                request->seed = seed;
+                header->submitted.store(++next, std::memory_order_release);
+                futexWake(header->submitted);
+                return next - 1;
+            }
+
+            // blocks until slot `seq` is done and returns it
+            std::uint8_t* wait(std::uint32_t seq) {
+                std::uint32_t done;
+                while (static_cast<std::int32_t>((done = header->completed.load(std::memory_order_acquire)) - seq) <= 0) {
+                    waitWhileEqual(header->completed, done);
+                }
+                return slotAt(header, seq);
+            }
+        };
+    }
+}
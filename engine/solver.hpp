@@ -0,0 +1,284 @@
+#pragma once
+
+// Klondike solver: depth-first search over the engine's own legalMoves()/apply()/undo(), walking a single
+// position in place rather than copying one per node, with
+//  - dominance: a card that can safely go up to its foundation is played as the only move
+//    (its rank is <= 2, or both opposite-colour foundations already hold rank - 1)
+//  - symmetry: a card that could go to several empty columns or empty foundations only tries the first,
+//    and a King-led column with nothing under it is never moved to another empty column
+//  - a face-up run is only split when the card it uncovers can go up to its foundation or take the waste top
+//  - talon macro moves: instead of single draws, every talon card reachable within one pass is played directly
+//    ("draw k, then play"), which keeps the stock cursor from multiplying the tree
+//  - move ordering: foundation moves and reveals first, talon plays next, foundation -> tableau last
+//  - a bounded transposition table of positions already explored (direct-mapped, always replace)
+// Win comes with the full move line. Loss is a proof: the tree was exhausted and only the sound rules above
+// cut it down. The run-splitting rule is a heuristic, so once it has dropped a move anywhere the result can
+// only be Unknown, as it is when the node budget runs out or some line goes deeper than maxDepth.
+
+#include <algorithm>
+#include <array>
+#include <cstdint>
+#include <vector>
+
+#include "klondike.hpp"
+
+namespace Klondike {
+
+    class Solver {
+    public:
+        struct Config {
+            std::uint64_t maxNodes = 2000000;
+            // in steps, a talon play counts once however many draws it takes. Every step is a recursion level
+            // holding 2-2.5 KB of stack (mostly its step list), so 1000 needs up to 2.5 MB: fine on a main
+            // thread or a Linux std::thread (8 MB), too much for 512 KB macOS secondary threads - lower it there.
+            int maxDepth = 1000;
+            int tableBits = 20;    // 2^tableBits entries of 8 bytes
+            bool canonical = true; // key on canonicalHash(), so column permutations share entries
+        };
+
+        enum class Result { Win, Loss, Unknown };
+
+        struct Outcome {
+            Result result {Result::Unknown};
+            std::vector<Move> line; // moves from the start position to the win, empty otherwise
+            std::uint64_t nodes {0};
+        };
+
+        Solver() : Solver(Config {}) {}
+        explicit Solver(const Config& config)
+            : config(config), table(std::size_t {1} << config.tableBits, 0) {}
+
+        Outcome solve(const State& start) {
+            std::fill(table.begin(), table.end(), 0);
+            nodes = 0;
+            outOfBudget = false;
+            cutOff = false;
+            guessed = false;
+            line.clear();
+            undos.clear();
+            position = start;
+
+            const bool won = search(0);
+            Outcome outcome;
+            outcome.result = won ? Result::Win : ((outOfBudget || cutOff || guessed) ? Result::Unknown : Result::Loss);
+            if (won) outcome.line = line;
+            outcome.nodes = nodes;
+            return outcome;
+        }
+
+    private:
+        Config config;
+        std::vector<std::uint64_t> table;
+        std::uint64_t nodes {0};
+        bool outOfBudget {false}; // node budget spent, the search unwinds
+        bool cutOff {false};      // some line hit maxDepth, so a loss is no longer a proof
+        bool guessed {false};     // the run-splitting heuristic dropped a move, same
+        std::vector<Move> line;
+        State position;           // the one position the search walks, moves go on with apply() and come off with undo()
+        std::vector<Undo> undos;  // one record per move in line
+
+        // the registry decides whether a later foundation move counts as progress, so it is part of the key here
+        std::uint64_t keyOf(const State& state) const {
+            const std::uint64_t key = (config.canonical ? state.canonicalHash() : state.hash())
+                                    ^ Zobrist::mix(state.getFoundationRegistry());
+            return key | 1; // 0 marks an empty slot
+        }
+
+        // true if the position was already explored (or is on the current path), marks it otherwise
+        bool seen(std::uint64_t key) {
+            std::uint64_t& slot = table[key & (table.size() - 1)];
+            if (slot == key) return true;
+            slot = key;
+            return false;
+        }
+
+        static int heightOf(const State& state, Suit suit) {
+            for (int f = 0; f < NO_OF_SUITS; ++f) {
+                const Card top = state.foundationTop(f);
+                if (top != NoCard && suitOf(top) == suit) return rankOf(top);
+            }
+            return 0;
+        }
+
+        static bool isSafeForFoundation(const State& state, Card card) {
+            const int rank = rankOf(card);
+            if (rank <= 2) return true;
+            const bool red = colourOf(card) == Colour::Red;
+            const int first = heightOf(state, red ? Suit::Clubs : Suit::Hearts);
+            const int second = heightOf(state, red ? Suit::Spades : Suit::Diamonds);
+            return first >= rank - 1 && second >= rank - 1;
+        }
+
+        static int firstEmptyTableau(const State& state) {
+            for (int t = 0; t < NO_OF_TABLEAUS; ++t) {
+                if (state.tableauSize(t) == 0) return t;
+            }
+            return -1;
+        }
+        static int firstEmptyFoundation(const State& state) {
+            for (int f = 0; f < NO_OF_SUITS; ++f) {
+                if (state.foundationTop(f) == NoCard) return f;
+            }
+            return -1;
+        }
+
+        static constexpr int Redundant = -1;   // dropped by a sound rule, something equivalent gets tried
+        static constexpr int Unpromising = -2; // dropped by the run-splitting heuristic
+
+        // < 0 drops the move (Redundant or Unpromising), otherwise higher is tried first
+        static int priorityOf(const State& state, const Move& move, int empty_tableau, int empty_foundation) {
+            const bool to_empty_tableau = move.kind != MoveKind::Draw && move.kind != MoveKind::WasteToFoundation
+                                       && move.kind != MoveKind::TableauToFoundation && state.tableauSize(move.to) == 0;
+            if (to_empty_tableau && move.to != empty_tableau) return Redundant;
+            const bool to_foundation = move.kind == MoveKind::WasteToFoundation || move.kind == MoveKind::TableauToFoundation;
+            if (to_foundation && state.foundationTop(move.to) == NoCard && move.to != empty_foundation) return Redundant;
+
+            switch (move.kind) {
+            case MoveKind::TableauToFoundation:
+                return (state.tableauSize(move.from) - 1 == state.hiddenCount(move.from) && state.hiddenCount(move.from) > 0) ? 95 : 90;
+            case MoveKind::TableauToTableau: {
+                const int size = state.tableauSize(move.from);
+                const int hidden = state.hiddenCount(move.from);
+                if (move.count == size - hidden && hidden > 0) return 80;          // reveals a card
+                if (move.count == size && to_empty_tableau) return Redundant;      // King column to another empty column
+                if (move.count == size) return 30;                                 // frees a column
+                if (move.count < size - hidden) {
+                    // splitting a face-up run only pays off if the card it uncovers has somewhere to go next
+                    const Card uncovered = state.tableauCard(move.from, size - move.count - 1);
+                    const bool to_foundation_next = rankOf(uncovered) == heightOf(state, suitOf(uncovered)) + 1;
+                    const bool waste_fits = state.wasteSize() > 0 && Rules::tableauCanStack(state.wasteTop(), uncovered);
+                    if (!to_foundation_next && !waste_fits) return Unpromising;
+                }
+                return 10;
+            }
+            case MoveKind::WasteToFoundation:
+                return 70;
+            case MoveKind::WasteToTableau:
+                return 60;
+            case MoveKind::Draw:
+                return 0;
+            case MoveKind::FoundationToTableau:
+                return 1;
+            }
+            return 0;
+        }
+
+        // a move to try, played after `draws` clicks on the stock
+        struct Step {
+            Move move;
+            std::uint8_t draws;
+        };
+        // every legal move plus the waste plays behind up to a full pass of draws, at most 3 targets per talon card
+        static constexpr int MAX_STEPS = MAX_LEGAL_MOVES + 3 * (NO_OF_CARDS - 28);
+
+        struct StepList {
+            std::array<Step, MAX_STEPS> steps;
+            std::array<int, MAX_STEPS> priority;
+            int count {0};
+
+            // insertion sort on priority, the lists are short; equal priorities keep their order
+            void add(const Move& move, int draws, int p) {
+                int pos = count++;
+                while (pos > 0 && priority[pos - 1] < p) {
+                    steps[pos] = steps[pos - 1];
+                    priority[pos] = priority[pos - 1];
+                    pos--;
+                }
+                steps[pos] = {move, static_cast<std::uint8_t>(draws)};
+                priority[pos] = p;
+            }
+        };
+
+        // Fills steps in the order to try them; a safe foundation move comes back alone.
+        // A bare draw is never a step of its own: drawing only matters for the card it lets you play,
+        // so each talon card that can go somewhere becomes "draw k times, then play it".
+        void orderedSteps(StepList& out) {
+            State& state = position;
+            MoveList legal;
+            legalMoves(state, legal);
+            const int empty_tableau = firstEmptyTableau(state);
+            const int empty_foundation = firstEmptyFoundation(state);
+            out.count = 0;
+
+            for (const Move& move : legal) {
+                Card card = NoCard;
+                if (move.kind == MoveKind::TableauToFoundation) card = state.tableauTop(move.from);
+                else if (move.kind == MoveKind::WasteToFoundation) card = state.wasteTop();
+                if (card != NoCard && isSafeForFoundation(state, card)
+                    && (state.foundationTop(move.to) != NoCard || move.to == empty_foundation)) {
+                    out.add(move, 0, 0);
+                    return;
+                }
+            }
+
+            for (const Move& move : legal) {
+                if (move.kind == MoveKind::Draw) continue;
+                const int p = priorityOf(state, move, empty_tableau, empty_foundation);
+                if (p >= 0) out.add(move, 0, p);
+                else if (p == Unpromising) guessed = true;
+            }
+
+            // one pass round the talon, drawn in place and taken back afterwards;
+            // the draws go through apply() so a stall ends the pass like in the game
+            const int pass = state.stockSize() + state.wasteSize();
+            int drawn = 0;
+            while (drawn < pass) {
+                pushMove(Move {MoveKind::Draw, 0, 0, 1});
+                drawn++;
+                if (state.isStalled()) break;
+                if (state.wasteSize() == 0) continue;
+                for (int f = 0; f < NO_OF_SUITS; ++f) {
+                    const Move move {MoveKind::WasteToFoundation, 0, static_cast<std::uint8_t>(f), 1};
+                    if (!isLegal(state, move)) continue;
+                    const int p = priorityOf(state, move, empty_tableau, empty_foundation);
+                    if (p >= 0) out.add(move, drawn, p - 1);
+                }
+                for (int t = 0; t < NO_OF_TABLEAUS; ++t) {
+                    const Move move {MoveKind::WasteToTableau, 0, static_cast<std::uint8_t>(t), 1};
+                    if (!isLegal(state, move)) continue;
+                    const int p = priorityOf(state, move, empty_tableau, empty_foundation);
+                    if (p >= 0) out.add(move, drawn, p - 1);
+                }
+            }
+            popMoves(drawn);
+        }
+
+        void pushMove(const Move& move) {
+            undos.push_back(apply(position, move));
+            line.push_back(move);
+        }
+        void popMoves(int n) {
+            for (; n > 0; --n) {
+                undo(position, undos.back());
+                undos.pop_back();
+                line.pop_back();
+            }
+        }
+
+        bool search(int depth) {
+            if (position.isWon()) return true;
+            if (position.isStalled()) return false;
+            if (++nodes > config.maxNodes) {
+                outOfBudget = true;
+                return false;
+            }
+            if (depth >= config.maxDepth) {
+                cutOff = true;
+                return false;
+            }
+            if (seen(keyOf(position))) return false;
+
+            StepList steps;
+            orderedSteps(steps);
+            for (int i = 0; i < steps.count; ++i) {
+                const Step& step = steps.steps[i];
+                for (int d = 0; d < step.draws; ++d) pushMove(Move {MoveKind::Draw, 0, 0, 1});
+                pushMove(step.move);
+                if (search(depth + 1)) return true;
+                popMoves(step.draws + 1);
+                if (outOfBudget) return false;
+            }
+            return false;
+        }
+    };
+}
@@ -0,0 +1,154 @@
+#pragma once
+
+// Small work-stealing pool for the batched environments.
+// Every worker (and the calling thread) owns a deque of range chunks; a thread pops from the back of its own
+// deque and steals from the front of the others once it runs dry, so uneven chunks even out on their own.
+
+#include <algorithm>
+#include <atomic>
+#include <condition_variable>
+#include <deque>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <type_traits>
+#include <vector>
+
+namespace Klondike {
+
+    class ThreadPool {
+    private:
+        struct Job {
+            void (*invoke)(void* fn, int begin, int end);
+            void* fn;
+            std::atomic<int> pending;
+        };
+        struct Task {
+            Job* job;
+            int begin, end;
+        };
+        struct Queue {
+            std::mutex lock;
+            std::deque<Task> tasks;
+        };
+
+        std::vector<std::unique_ptr<Queue>> queues; // queues[0] belongs to whoever calls parallelFor()
+        std::vector<std::thread> workers;
+
+        std::mutex sleepLock;
+        std::condition_variable wake;
+        std::atomic<int> queued {0};
+        std::atomic<bool> stopping {false};
+        int spinsBeforeSleep;
+
+        bool popLocal(int q, Task& task) {
+            std::lock_guard<std::mutex> guard(queues[q]->lock);
+            if (queues[q]->tasks.empty()) return false;
+            task = queues[q]->tasks.back();
+            queues[q]->tasks.pop_back();
+            queued--;
+            return true;
+        }
+        bool steal(int q, Task& task) {
+            const int n = static_cast<int>(queues.size());
+            for (int i = 1; i < n; ++i) {
+                Queue& victim = *queues[(q + i) % n];
+                std::lock_guard<std::mutex> guard(victim.lock);
+                if (victim.tasks.empty()) continue;
+                task = victim.tasks.front();
+                victim.tasks.pop_front();
+                queued--;
+                return true;
+            }
+            return false;
+        }
+        bool next(int q, Task& task) { return popLocal(q, task) || steal(q, task); }
+
+        static void run(const Task& task) {
+            task.job->invoke(task.job->fn, task.begin, task.end);
+            task.job->pending.fetch_sub(1, std::memory_order_acq_rel);
+        }
+
+        void workerLoop(int q) {
+            Task task;
+            int idle = 0;
+            while (!stopping.load(std::memory_order_acquire)) {
+                if (next(q, task)) {
+                    run(task);
+                    idle = 0;
+                } else if (++idle < spinsBeforeSleep) {
+                    std::this_thread::yield(); // the next batch often follows right away, stay warm for a moment
+                } else {
+                    std::unique_lock<std::mutex> guard(sleepLock);
+                    wake.wait(guard, [this] { return queued.load() > 0 || stopping.load(); });
+                    idle = 0;
+                }
+            }
+        }
+
+    public:
+        // yields an idle worker tries before it sleeps: a few microseconds, so pools that sit idle between
+        // searches or batches don't keep cores busy
+        static constexpr int DefaultSpins = 64;
+
+        // threads counts the calling thread too; 0 picks std::thread::hardware_concurrency()
+        explicit ThreadPool(int threads = 0, int spins = DefaultSpins) : spinsBeforeSleep(std::max(spins, 0)) {
+            if (threads <= 0) threads = static_cast<int>(std::thread::hardware_concurrency());
+            if (threads <= 0) threads = 1;
+            for (int i = 0; i < threads; ++i) queues.push_back(std::make_unique<Queue>());
+            for (int i = 1; i < threads; ++i) workers.emplace_back(&ThreadPool::workerLoop, this, i);
+        }
+
+        ~ThreadPool() {
+            {
+                std::lock_guard<std::mutex> guard(sleepLock);
+                stopping = true;
+            }
+            wake.notify_all();
+            for (auto& worker : workers) worker.join();
+        }
+
+        ThreadPool(const ThreadPool&) = delete;
+        ThreadPool& operator=(const ThreadPool&) = delete;
+
+        int size() const { return static_cast<int>(queues.size()); }
+
+        // calls fn(lo, hi) over [begin, end) in chunks of at most grain, returns when every chunk is done.
+        // Meant to be driven from one thread at a time (the env batch owning the pool).
+        template <typename Fn>
+        void parallelFor(int begin, int end, int grain, Fn&& fn) {
+            if (end <= begin) return;
+            if (grain < 1) grain = 1;
+            if (workers.empty() || end - begin <= grain) {
+                fn(begin, end);
+                return;
+            }
+
+            Job job;
+            job.invoke = [](void* f, int lo, int hi) { (*static_cast<std::remove_reference_t<Fn>*>(f))(lo, hi); };
+            job.fn = const_cast<void*>(static_cast<const void*>(&fn));
+            job.pending = (end - begin + grain - 1) / grain;
+
+            int q = 0;
+            for (int lo = begin; lo < end; lo += grain) {
+                Queue& queue = *queues[q];
+                {
+                    std::lock_guard<std::mutex> guard(queue.lock);
+                    queue.tasks.push_back({&job, lo, std::min(lo + grain, end)});
+                }
+                queued++;
+                q = (q + 1) % size();
+            }
+            {
+                std::lock_guard<std::mutex> guard(sleepLock); // pairs with the predicate check in workerLoop()
+            }
+            wake.notify_all();
+
+            Task task;
+            while (job.pending.load(std::memory_order_acquire) > 0) {
+                if (next(0, task)) run(task);
+                else std::this_thread::yield();
+            }
+        }
+    };
+}
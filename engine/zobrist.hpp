@@ -0,0 +1,65 @@
+#pragma once
+
+// Zobrist keys for Klondike::State. The tables are built at compile time from a fixed splitmix64 sequence,
+// so hashes are identical across runs and processes (safe to store in solver tables or send to a trainer).
+//
+// Exact key: XOR over (card, location, face-up) plus the waste cursor and the cycle flags.
+// Canonical key: the same, except tableau columns are hashed on their own with column-independent keys
+// and combined with a commutative sum, so positions that only differ by which column holds what collide.
+
+#include <cstdint>
+
+#include "cards.hpp"
+
+namespace Klondike {
+
+    namespace Zobrist {
+
+        constexpr int TalonSize = NO_OF_CARDS - NO_OF_TABLEAUS * (NO_OF_TABLEAUS + 1) / 2; // 24
+        constexpr int NoOfFlagStates = 4;
+
+        struct Keys {
+            std::uint64_t tableau[NO_OF_TABLEAUS][NO_OF_CARDS][2]; // [column][card][face up]
+            std::uint64_t column[NO_OF_CARDS][2];                  // [card][face up], column order doesn't matter
+            std::uint64_t stock[NO_OF_CARDS];
+            std::uint64_t waste[NO_OF_CARDS];
+            std::uint64_t foundation[NO_OF_SUITS][NO_OF_CARDS];
+            std::uint64_t cursor[TalonSize + 1];                   // cards in the waste
+            std::uint64_t flags[NoOfFlagStates];
+        };
+
+        constexpr std::uint64_t splitmix64(std::uint64_t& state) {
+            std::uint64_t z = (state += 0x9E3779B97F4A7C15ull);
+            z = (z ^ (z >> 30)) * 0xBF58476D1CE4E5B9ull;
+            z = (z ^ (z >> 27)) * 0x94D049BB133111EBull;
+            return z ^ (z >> 31);
+        }
+
+        // finaliser used to spread a column's XOR key before the commutative sum
+        constexpr std::uint64_t mix(std::uint64_t z) {
+            z = (z ^ (z >> 33)) * 0xFF51AFD7ED558CCDull;
+            z = (z ^ (z >> 33)) * 0xC4CEB9FE1A85EC53ull;
+            return z ^ (z >> 33);
+        }
+
+        constexpr Keys makeKeys() {
+            Keys keys {};
+            std::uint64_t seed = 0x4B4C4F4E44494B45ull; // "KLONDIKE"
+            for (auto& column : keys.tableau)
+                for (auto& card : column)
+                    for (auto& key : card) key = splitmix64(seed);
+            for (auto& card : keys.column)
+                for (auto& key : card) key = splitmix64(seed);
+            for (auto& key : keys.stock) key = splitmix64(seed);
+            for (auto& key : keys.waste) key = splitmix64(seed);
+            for (auto& foundation : keys.foundation)
+                for (auto& key : foundation) key = splitmix64(seed);
+            for (auto& key : keys.cursor) key = splitmix64(seed);
+            keys.flags[0] = 0; // no flags set contributes nothing
+            for (int i = 1; i < NoOfFlagStates; ++i) keys.flags[i] = splitmix64(seed);
+            return keys;
+        }
+
+        inline constexpr Keys keys = makeKeys();
+    }
+}
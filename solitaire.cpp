@@ -7,16 +7,28 @@
 #include <iostream>
 #include <set>
 
-#include <ctime>
+#include <cstdio>
+#include <cstdlib>
 #include <random>
 #include <algorithm>
+#include <array>
+#include <atomic>
+#include <chrono>
+#include <mutex>
+#include <thread>
+
+#include "engine/klondike.hpp"
+#include "engine/assetpack.hpp"
+#include "engine/log.hpp"
+#include "engine/envserver.hpp"
+#include "engine/threadpool.hpp"
 
 #define INITIAL_WIDTH 1200
 #define INITIAL_HEIGHT 950
 
-#define DEFAULT_SUIT_LENGTH 13
-#define DEFAULT_NO_OF_SUITS 4
-#define DEFAULT_NO_OF_TABLEAUS 7
+#define DEFAULT_SUIT_LENGTH Klondike::SUIT_LENGTH
+#define DEFAULT_NO_OF_SUITS Klondike::NO_OF_SUITS
+#define DEFAULT_NO_OF_TABLEAUS Klondike::NO_OF_TABLEAUS
 
 // Master(ful) SCREEN Enum 
 enum class Screen {
@@ -40,10 +52,46 @@ Stack* gStack = nullptr;
 
 bool aiMode {false}; // 19 Oct 2024 - this is going to be bad
 
+// deal number of the next game: random unless --seed is passed, and logged so any game can be replayed
+std::uint64_t nextDealSeed {0};
+
+// --serve NAME: no window, host envs for a trainer over shared memory instead (engine/shmproto.hpp)
+struct ServeOptions {
+	std::string name;
+	int envs {1024};
+	int threads {0};
+	int slots {2};
+} serveOptions;
+
+// --fps N: presents paced to N per second by the loop itself; 0 (default) leaves pacing to vsync
+int frameRateCap {0};
+// with nothing to draw the loop sleeps in SDL_WaitEventTimeout for up to this long
+const int idleWaitMs = 500;
+
+// The board is composed at a logical resolution (scrWidth x scrHeight) and the renderer scales it to the window.
+// A window resize only takes effect once the size has held still for resizeSettleMs, so a drag-resize just
+// scales the last frame instead of rebuilding layout and layers on every SIZE_CHANGED.
+// --logical WxH pins the resolution for good: resizes then only ever scale.
+const Uint32 resizeSettleMs = 150;
+bool fixedLogicalSize {false};
+struct PendingResize {
+	bool pending {false};
+	int width {0}, height {0};
+	Uint32 since {0};
+} pendingResize;
+
+// prebaked pixels from tools/pack.cpp; without it every image is decoded from its PNG
+std::string packPath = "assets/assets.pack";
+bool packPathGiven {false};
+
 int scrWidth = INITIAL_WIDTH;
 int scrHeight = INITIAL_HEIGHT;
 
-enum class Suit { Hearts, Diamonds, Clubs, Spades };
+// cold start is reported against this (set during static init, so before main())
+const std::chrono::steady_clock::time_point launchTime = std::chrono::steady_clock::now();
+double msSinceLaunch() { return std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - launchTime).count(); }
+
+using Suit = Klondike::Suit; // the GUI shares the engine's card model
 
 enum class GameStatus {
     Good,
@@ -139,12 +187,44 @@ namespace SDLW {
         return (it != cardPaths.end()) ? it->second : emptyString;
     }
 
-    SDL_Texture* loadTexture(std::string path) {
-        SDL_Surface* loadedSurface = IMG_Load(path.c_str());
-        if (!loadedSurface) {
+    Klondike::Pack::Reader assetPack; // mapped once by init(), read-only afterwards
+
+    // An RGBA32 surface for an asset: straight over the asset pack's mapping if the image is in it (nothing
+    // copied, nothing decoded), else decoded from the PNG. Touches no renderer state, so any thread can call it;
+    // only the texture upload has to happen on the render thread.
+    SDL_Surface* decodeImage(const std::string& path) {
+        if (const Klondike::Pack::Entry* entry = assetPack.find(path)) {
+            return SDL_CreateRGBSurfaceWithFormatFrom(const_cast<std::uint8_t*>(assetPack.pixels(*entry)), entry->width, entry->height,
+                                                      32, entry->pitch, SDL_PIXELFORMAT_RGBA32);
+        }
+        SDL_Surface* loaded = IMG_Load(path.c_str());
+        SDL_Surface* image = loaded ? SDL_ConvertSurfaceFormat(loaded, SDL_PIXELFORMAT_RGBA32, 0) : nullptr;
+        if (loaded) SDL_FreeSurface(loaded);
+        if (!image) {
             std::cerr << "Unable to load image: " << path << ", error: " << SDL_GetError() << std::endl;
-            return nullptr;
         }
+        return image;
+    }
+
+    // The one pool every parallel decode runs on, built on first use and kept for the process (its workers
+    // sleep while idle), so a batch of images doesn't start and join a thread per core every time.
+    Klondike::ThreadPool& decodePool() {
+        static Klondike::ThreadPool pool;
+        return pool;
+    }
+    std::mutex decodeLock; // parallelFor() wants one driving thread at a time
+
+    // fn(lo, hi) over [0, count) on the decode pool. Callers take turns, though in practice they never
+    // overlap: the menu images load before the atlas preload starts.
+    template <typename Fn>
+    void decodeInParallel(int count, Fn&& fn) {
+        std::lock_guard<std::mutex> guard(decodeLock);
+        decodePool().parallelFor(0, count, 1, fn);
+    }
+
+    SDL_Texture* loadTexture(std::string path) {
+        SDL_Surface* loadedSurface = decodeImage(path);
+        if (!loadedSurface) return nullptr;
 
         SDL_Texture* newTexture = SDL_CreateTextureFromSurface(gRenderer, loadedSurface);
         if (!newTexture) {
@@ -181,6 +261,11 @@ namespace SDLW {
         drawTextureAbsolute(texture, rect);
     }
 
+    void drawPartToWindow(SDL_Texture* texture, const SDL_Rect& srcRect, const SDL_Rect& destRect) { // for pooled targets, only their top-left is used
+        SDL_SetTextureBlendMode(texture, SDL_BLENDMODE_BLEND);
+        SDL_RenderCopy(gRenderer, texture, &srcRect, &destRect);
+    }
+
     const std::string backTexturePath = "assets/cards/back.png";
 
     void renderClear() {
@@ -188,12 +273,263 @@ namespace SDLW {
     }
 
     void renderPresent() {
+        if (frameRateCap > 0) { // no vsync then: keep presents at least one frame apart
+            static Uint64 lastPresent = 0;
+            const Uint64 frequency = SDL_GetPerformanceFrequency();
+            const Uint64 interval = frequency / frameRateCap;
+            const Uint64 now = SDL_GetPerformanceCounter();
+            if (lastPresent && now - lastPresent < interval) {
+                SDL_Delay(static_cast<Uint32>((interval - (now - lastPresent)) * 1000 / frequency));
+            }
+            lastPresent = SDL_GetPerformanceCounter();
+        }
         SDL_RenderPresent(gRenderer);
     }
 
     bool mouseInRect(const SDL_Rect& rect, const SDL_Point& point) {
         return SDL_PointInRect(&point, &rect);
     }
+
+    const std::string emptyTexturePath = "assets/cards/empty.png";
+
+    // All 52 faces, the back and the empty-pile marker scaled into one texture, so a whole board is one draw call.
+    // Cells are indexed by card id (Klondike::Card), then back and empty.
+    namespace Atlas {
+        const int cellWidth = 328;   // half the size of the source PNGs, still bigger than a card on a 4K window
+        const int cellHeight = 465;
+        const int columns = 8;
+        const int backCell = Klondike::NO_OF_CARDS;
+        const int emptyCell = backCell + 1;
+        const int cells = emptyCell + 1;
+        const int width = columns * cellWidth;
+        const int height = ((cells + columns - 1) / columns) * cellHeight;
+
+        SDL_Texture* texture = nullptr;
+
+        SDL_Rect cellRect(int cell) {
+            return {(cell % columns) * cellWidth, (cell / columns) * cellHeight, cellWidth, cellHeight};
+        }
+
+        const std::string& cellPath(int cell) {
+            if (cell == backCell) return backTexturePath;
+            if (cell == emptyCell) return emptyTexturePath;
+            return getCardPath(Klondike::suitOf(static_cast<Klondike::Card>(cell)), Klondike::rankOf(static_cast<Klondike::Card>(cell)));
+        }
+
+        // CPU half: decodes every PNG in parallel and scales each into its cell. Safe off the render thread.
+        SDL_Surface* compose() {
+            SDL_Surface* atlas = SDL_CreateRGBSurfaceWithFormat(0, width, height, 32, SDL_PIXELFORMAT_RGBA32);
+            if (!atlas) {
+                std::cerr << "Unable to create the card atlas surface: " << SDL_GetError() << std::endl;
+                return nullptr;
+            }
+            std::vector<SDL_Surface*> images(cells, nullptr);
+            decodeInParallel(cells, [&images](int lo, int hi) {
+                for (int cell = lo; cell < hi; ++cell) {
+                    // a pack baked with --scale at the cell size makes the blit below a plain copy
+                    const std::string prescaled = Klondike::Pack::scaledName(cellPath(cell), cellWidth, cellHeight);
+                    images[cell] = decodeImage(assetPack.find(prescaled) ? prescaled : cellPath(cell));
+                }
+            });
+            bool complete = true;
+            for (int cell = 0; cell < cells; ++cell) { // blits stay on one thread, they all write the same surface
+                if (!images[cell]) {
+                    complete = false;
+                    continue;
+                }
+                SDL_SetSurfaceBlendMode(images[cell], SDL_BLENDMODE_NONE); // copy alpha as is
+                SDL_Rect dst = cellRect(cell);
+                SDL_BlitScaled(images[cell], nullptr, atlas, &dst);
+                SDL_FreeSurface(images[cell]);
+            }
+            if (!complete) {
+                SDL_FreeSurface(atlas);
+                return nullptr;
+            }
+            return atlas;
+        }
+
+        // render thread half: one texture upload, takes ownership of the surface
+        bool upload(SDL_Surface* atlas) {
+            if (!atlas) return false;
+            texture = SDL_CreateTextureFromSurface(gRenderer, atlas);
+            SDL_FreeSurface(atlas);
+            if (!texture) {
+                std::cerr << "Unable to create the card atlas texture: " << SDL_GetError() << std::endl;
+                return false;
+            }
+            SDL_SetTextureBlendMode(texture, SDL_BLENDMODE_BLEND);
+            return true;
+        }
+
+        void destroy() {
+            if (texture) SDL_DestroyTexture(texture);
+            texture = nullptr;
+        }
+    }
+
+    // Composes the card atlas on a background thread while the Home screen is up, so pressing Play
+    // usually finds it ready and only pays the upload.
+    namespace Preload {
+        std::thread worker;
+        std::atomic<bool> finished {false};
+        SDL_Surface* atlasSurface = nullptr; // published by `finished`
+
+        void start() {
+            worker = std::thread([] {
+                atlasSurface = Atlas::compose();
+                finished.store(true, std::memory_order_release);
+                SDL_Event wake {}; // the main loop may be asleep in SDL_WaitEventTimeout, Home uploads it on waking
+                wake.type = SDL_USEREVENT;
+                SDL_PushEvent(&wake);
+            });
+        }
+
+        bool running() { return worker.joinable(); }
+        bool ready() { return running() && finished.load(std::memory_order_acquire); }
+
+        SDL_Surface* take() { // waits if it isn't done yet
+            worker.join();
+            finished = false;
+            SDL_Surface* surface = atlasSurface;
+            atlasSurface = nullptr;
+            return surface;
+        }
+    }
+
+    // Owns every texture loaded from assets/ for the whole process: the first request decodes and uploads,
+    // every later one (new Deck, back to Home, next game) is a lookup. Only close() empties it.
+    namespace TextureCache {
+        std::unordered_map<std::string, SDL_Texture*> textures; // by asset path
+
+        // decodes the ones not cached yet in parallel, then uploads them here on the render thread
+        void preload(const std::vector<std::string>& paths) {
+            std::vector<std::string> missing;
+            for (const std::string& path : paths) {
+                if (!textures.count(path)) missing.push_back(path);
+            }
+            std::vector<SDL_Surface*> images(missing.size(), nullptr);
+            decodeInParallel(static_cast<int>(missing.size()), [&](int lo, int hi) {
+                for (int i = lo; i < hi; ++i) images[i] = decodeImage(missing[i]);
+            });
+            for (size_t i = 0; i < missing.size(); ++i) {
+                if (!images[i]) continue; // get() retries and reports it
+                SDL_Texture* texture = SDL_CreateTextureFromSurface(gRenderer, images[i]);
+                SDL_FreeSurface(images[i]);
+                if (texture) textures.emplace(missing[i], texture);
+            }
+        }
+
+        SDL_Texture* get(const std::string& path) {
+            auto it = textures.find(path);
+            if (it != textures.end()) return it->second;
+            SDL_Texture* texture = loadTexture(path);
+            if (texture) textures.emplace(path, texture); // failures aren't cached, the next call retries
+            return texture;
+        }
+
+        SDL_Texture* atlas() {
+            if (!Atlas::texture) {
+                if (!Atlas::upload(Preload::running() ? Preload::take() : Atlas::compose())) return nullptr;
+                LOG_INFO("Card atlas ready ", msSinceLaunch(), " ms after launch");
+            }
+            return Atlas::texture;
+        }
+
+        void clear() { // before the renderer goes away
+            if (Preload::running()) {
+                SDL_Surface* unused = Preload::take();
+                if (unused) SDL_FreeSurface(unused);
+            }
+            for (auto& entry : textures) SDL_DestroyTexture(entry.second);
+            textures.clear();
+            Atlas::destroy();
+        }
+    }
+
+    // Render targets handed out again and again instead of one SDL_CreateTexture per drag. Sizes are rounded up to
+    // buckets, so a target fits every drag of a similar size; callers draw into and from its top-left corner only.
+    // A target is only replaced by a bigger one when nothing free is large enough (e.g. after the window grew).
+    namespace TargetPool {
+        struct Target {
+            SDL_Texture* texture;
+            int w, h;
+            bool inUse;
+        };
+        std::vector<Target> targets;
+
+        const int bucketSize = 128;
+        int bucket(int size) { return std::max(1, (size + bucketSize - 1) / bucketSize) * bucketSize; }
+
+        SDL_Texture* acquire(int w, int h) {
+            Target* best = nullptr;
+            for (Target& target : targets) { // smallest free one that fits
+                if (!target.inUse && target.w >= w && target.h >= h && (!best || target.w * target.h < best->w * best->h)) best = &target;
+            }
+            if (best) {
+                best->inUse = true;
+                return best->texture;
+            }
+            // growing: free targets that were too small are dropped rather than kept around
+            targets.erase(std::remove_if(targets.begin(), targets.end(), [](const Target& target) {
+                if (target.inUse) return false;
+                SDL_DestroyTexture(target.texture);
+                return true;
+            }), targets.end());
+            const int bw = bucket(w), bh = bucket(h);
+            SDL_Texture* texture = SDL_CreateTexture(gRenderer, SDL_PIXELFORMAT_RGBA8888, SDL_TEXTUREACCESS_TARGET, bw, bh);
+            if (!texture) {
+                std::cerr << "Unable to create a " << bw << "x" << bh << " render target: " << SDL_GetError() << std::endl;
+                return nullptr;
+            }
+            SDL_SetTextureBlendMode(texture, SDL_BLENDMODE_BLEND);
+            targets.push_back({texture, bw, bh, true});
+            return texture;
+        }
+
+        void release(SDL_Texture* texture) {
+            for (Target& target : targets) {
+                if (target.texture == texture) target.inUse = false;
+            }
+        }
+
+        void clear() { // before the renderer goes away
+            for (Target& target : targets) SDL_DestroyTexture(target.texture);
+            targets.clear();
+        }
+    }
+
+    // Card quads collected over a frame and sent to SDL_RenderGeometry in one go (needs SDL 2.0.18+).
+    class CardBatch {
+    private:
+        std::vector<SDL_Vertex> vertices;
+        std::vector<int> indices;
+
+    public:
+        void clear() { vertices.clear(); indices.clear(); }
+        bool empty() const { return vertices.empty(); }
+
+        void addCard(int cell, const SDL_Rect& rect) {
+            const SDL_Rect src = Atlas::cellRect(cell);
+            const float u0 = static_cast<float>(src.x) / Atlas::width, u1 = static_cast<float>(src.x + src.w) / Atlas::width;
+            const float v0 = static_cast<float>(src.y) / Atlas::height, v1 = static_cast<float>(src.y + src.h) / Atlas::height;
+            const float x0 = static_cast<float>(rect.x), x1 = static_cast<float>(rect.x + rect.w);
+            const float y0 = static_cast<float>(rect.y), y1 = static_cast<float>(rect.y + rect.h);
+            const SDL_Color white = {255, 255, 255, 255};
+            const int base = static_cast<int>(vertices.size());
+            vertices.push_back({{x0, y0}, white, {u0, v0}});
+            vertices.push_back({{x1, y0}, white, {u1, v0}});
+            vertices.push_back({{x1, y1}, white, {u1, v1}});
+            vertices.push_back({{x0, y1}, white, {u0, v1}});
+            for (int corner : {0, 1, 2, 0, 2, 3}) indices.push_back(base + corner);
+        }
+
+        void draw() const { // onto whatever the render target is
+            if (empty()) return;
+            SDL_RenderGeometry(gRenderer, Atlas::texture, vertices.data(), static_cast<int>(vertices.size()),
+                               indices.data(), static_cast<int>(indices.size()));
+        }
+    };
 }
 
 enum class Alignment {
@@ -201,32 +537,27 @@ enum class Alignment {
     Horizontal
 };
 
-enum class Colour {
-    Red,
-    Black
-};
+using Colour = Klondike::Colour;
 
 class Card {
 private:
     Suit suit;
     int rank;
     bool visible;
-    SDL_Texture* texture;
     SDL_Rect rect;
 
 public:
-	static const int Ace = 1; // RANKS ARE 1-INDEXED (1 to 13)
-	static const int King = 13;
+	static const int Ace = Klondike::Ace; // RANKS ARE 1-INDEXED (1 to 13)
+	static const int King = Klondike::King;
 
-    Card() : suit(Suit::Hearts), rank(1), visible(false), texture(nullptr), rect{0, 0, 0, 0} {}
+    Card() : suit(Suit::Hearts), rank(1), visible(false), rect{0, 0, 0, 0} {}
 
     int getRank() const { return rank; }
     Suit getSuit() const { return suit; }
-    Colour getColour() const {
-        return (suit == Suit::Hearts || suit == Suit::Diamonds) ? Colour::Red : Colour::Black;
-    }
+    Colour getColour() const { return Klondike::colourOf(getId()); }
+    Klondike::Card getId() const { return Klondike::makeCard(suit, rank); } // also the index into Deck::cardStore
     bool isVisible() const { return visible; }
-    SDL_Texture* getTexture() const { return texture; }
+    int getAtlasCell() const { return visible ? getId() : SDLW::Atlas::backCell; }
     const SDL_Rect& getRect() const { return rect; }
     int getCardX() const { return rect.x; }
     int getCardY() const { return rect.y; }
@@ -234,7 +565,6 @@ public:
     void setRank(int new_rank) { rank = new_rank; }
     void setSuit(Suit new_suit) { suit = new_suit; }
     void setVisible(bool new_visible) { visible = new_visible; }
-    void setTexture(SDL_Texture* new_texture) { texture = new_texture; }
     void setRect(const SDL_Rect& new_rect) { rect = new_rect; }
 };
 
@@ -245,39 +575,18 @@ private:
     int offset;
     int x, y;
     int cardWidth, cardHeight;
-    SDL_Texture* pileTexture;
     SDL_Rect pileRect;
 
 public:
-    static SDL_Texture* cardBackTexture;
-
-    Pile() : pileTexture(nullptr), pileRect{0, 0, 0, 0} {}
-
-    ~Pile() {
-        if (pileTexture) {
-            SDL_DestroyTexture(pileTexture);
-        }
-    }
+    Pile() : pileRect{0, 0, 0, 0} {}
 
     void setAlignment(Alignment new_alignment) { alignment = new_alignment; }
     void setOffset(int new_offset) { offset = new_offset; }
     void setPosition(int new_x, int new_y) { x = new_x; y = new_y; }
 
-    void updatePileTexture() {
-        if (pileTexture) {
-            SDL_DestroyTexture(pileTexture);
-            pileTexture = nullptr;
-        }
-        pileTexture = SDL_CreateTexture(gRenderer, SDL_PIXELFORMAT_RGBA8888, SDL_TEXTUREACCESS_TARGET, cardWidth, getPileTextureHeight());
-        if (!pileTexture) {
-            std::cerr << "Error initialising pileTexture for pile" << std::endl;
-        }
-    }
-
     void setCardDimensions(int new_width, int new_height) { 
         cardWidth = new_width; 
         cardHeight = new_height;
-        updatePileTexture();
         // std::cout << "Card Dimensions set: " << cardWidth << "x" << cardHeight << std::endl; // Log dimensions
     }
 
@@ -300,41 +609,23 @@ public:
         if (top()) cards.pop_back();
     }
 
-    void renderAllCards() {
-        SDLW::setTarget(pileTexture);
-        SDLW::renderClear();
-
-        SDL_Rect rect;
-        rect.w = cardWidth;
-        rect.h = cardHeight;
-        rect.x = 0; // x is locally 0 regardless
-
+    void layoutCards() { // card rects in window coordinates, hit testing and drawing both use them
         if (isTableau()) {
             for (size_t i = 0; i < size(); ++i) {
-                Card* card = cards[i];
-                rect.y = i * offset; // Stack vertically with the defined offset
-
-                card->setRect({getX(), getY() + rect.y, cardWidth, cardHeight});
-
-                if (card->isVisible()) {
-                    SDLW::drawToTexture(card->getTexture(), rect);
-                } else {
-                    SDLW::drawToTexture(cardBackTexture, rect);
-                }
+                cards[i]->setRect({getX(), getY() + static_cast<int>(i) * offset, cardWidth, cardHeight}); // Stack vertically with the defined offset
             }
-        } else {
-            if (!cards.empty()) {
-                Card* topCard = top();
-                rect.y = 0; // Always start at 0 for non-tableau
-
-                topCard->setRect({getX(), getY(), cardWidth, cardHeight});
+        } else if (!cards.empty()) {
+            top()->setRect({getX(), getY(), cardWidth, cardHeight});
+        }
+    }
 
-                if (topCard->isVisible()) {
-                    SDLW::drawToTexture(topCard->getTexture(), rect);
-                } else {
-                    SDLW::drawToTexture(cardBackTexture, rect);
-                }
-            }
+    void addToBatch(SDLW::CardBatch& batch) const {
+        if (cards.empty()) {
+            batch.addCard(SDLW::Atlas::emptyCell, {getX(), getY(), cardWidth, cardHeight});
+        } else if (isTableau()) {
+            for (const Card* card : cards) batch.addCard(card->getAtlasCell(), card->getRect());
+        } else {
+            batch.addCard(top()->getAtlasCell(), top()->getRect());
         }
     }
 
@@ -363,20 +654,18 @@ public:
     }
 
     int getPileTextureHeight() const { return (offset * (size() - 1)) + cardHeight; } // for non zero values
-    SDL_Texture* getPileTexture() const { return pileTexture; }
     const SDL_Rect& getPileRect() const { return pileRect; }
+    SDL_Rect getDrawnRect() const { return {pileRect.x, pileRect.y, pileRect.w, std::max(pileRect.h, cardHeight)}; } // an empty pile still shows its marker
 
-    void recomputeAndRender() {
-    	setPileRect(); // forgot to change the rects HERE actually, the other is just texture
-    	updatePileTexture(); // forgot to change rects
-    	renderAllCards();
-    	// this entire function was initially renderPileAgain()
+    void recomputeLayout() {
+    	setPileRect();
+    	layoutCards();
+    	// this entire function was initially renderPileAgain(), then recomputeAndRender() when piles had their own textures
     }
 
     void setTopVisible() { if (!empty()) cards.back()->setVisible(true); }
     void setTopInvisible() { if (!empty()) cards.back()->setVisible(false); }
 };
-SDL_Texture* Pile::cardBackTexture = nullptr;
 
 namespace DeckFormulae {
     int getGlobalCardW() {
@@ -424,6 +713,79 @@ namespace DeckFormulae {
     }
 }
 
+// DeckFormulae worked out once per window size instead of on every use, plus per-pixel column maps so that
+// hit-testing is a couple of array reads and a division, however many piles and cards there are.
+namespace Layout {
+    const int NoColumn = -1;
+    const int StockColumn = Klondike::NO_OF_SUITS;   // top row: foundations are 0..3, then stock and waste
+    const int WasteColumn = Klondike::NO_OF_SUITS + 1;
+
+    struct Table {
+        int width = 0, height = 0; // window size it was built for
+        int cardW = 0, cardH = 0;
+        int tableauOffset = 0;
+        SDL_Rect stock = {0, 0, 0, 0};
+        SDL_Rect waste = {0, 0, 0, 0};
+        std::array<SDL_Rect, Klondike::NO_OF_SUITS> foundations {};
+        std::array<SDL_Rect, Klondike::NO_OF_TABLEAUS> tableaus {}; // slot of the first card
+        int topRowY = 0;
+        int tableauY = 0;
+        std::vector<std::int8_t> topColumn;     // x -> foundation index, StockColumn, WasteColumn or NoColumn
+        std::vector<std::int8_t> tableauColumn; // x -> tableau index or NoColumn
+    };
+    Table table;
+
+    void rebuild() { // on resize; a no-op if the window size didn't change
+        if (table.width == scrWidth && table.height == scrHeight) return;
+        table.width = scrWidth;
+        table.height = scrHeight;
+        table.cardW = DeckFormulae::getGlobalCardW();
+        table.cardH = DeckFormulae::getGlobalCardH();
+        table.tableauOffset = DeckFormulae::getTableauOffset();
+        table.stock = {DeckFormulae::getStockX(), DeckFormulae::getStockY(), table.cardW, table.cardH};
+        table.waste = {DeckFormulae::getWasteX(), DeckFormulae::getWasteY(), table.cardW, table.cardH};
+        for (int i = 0; i < Klondike::NO_OF_SUITS; ++i) {
+            table.foundations[i] = {DeckFormulae::getFoundationX(i), DeckFormulae::getFoundationY(i), table.cardW, table.cardH};
+        }
+        for (int i = 0; i < Klondike::NO_OF_TABLEAUS; ++i) {
+            table.tableaus[i] = {DeckFormulae::getTableauX(i), DeckFormulae::getTableauY(i), table.cardW, table.cardH};
+        }
+        table.topRowY = table.stock.y;
+        table.tableauY = table.tableaus[0].y;
+
+        auto mark = [](std::vector<std::int8_t>& columns, const SDL_Rect& rect, int value) {
+            const int from = std::max(rect.x, 0), to = std::min(rect.x + rect.w, static_cast<int>(columns.size()));
+            for (int x = from; x < to; ++x) columns[x] = static_cast<std::int8_t>(value);
+        };
+        table.topColumn.assign(std::max(scrWidth, 0), NoColumn);
+        table.tableauColumn.assign(std::max(scrWidth, 0), NoColumn);
+        for (int i = 0; i < Klondike::NO_OF_SUITS; ++i) mark(table.topColumn, table.foundations[i], i);
+        mark(table.topColumn, table.stock, StockColumn);
+        mark(table.topColumn, table.waste, WasteColumn);
+        for (int i = 0; i < Klondike::NO_OF_TABLEAUS; ++i) mark(table.tableauColumn, table.tableaus[i], i);
+    }
+
+    // top row slot under the point, or NoColumn
+    int topRowAt(const SDL_Point& point) {
+        if (point.x < 0 || point.x >= static_cast<int>(table.topColumn.size())) return NoColumn;
+        if (point.y < table.topRowY || point.y >= table.topRowY + table.cardH) return NoColumn;
+        return table.topColumn[point.x];
+    }
+
+    // tableau column under the point (ignoring how long the piles are), or NoColumn
+    int tableauColumnAt(const SDL_Point& point) {
+        if (point.x < 0 || point.x >= static_cast<int>(table.tableauColumn.size()) || point.y < table.tableauY) return NoColumn;
+        return table.tableauColumn[point.x];
+    }
+
+    // card of a pile of `cards` cards fanned down from the tableau row, or -1 below the last one
+    int tableauRowAt(const SDL_Point& point, int cards) {
+        const int dy = point.y - table.tableauY;
+        if (cards <= 0 || dy < 0 || dy >= table.tableauOffset * (cards - 1) + table.cardH) return -1;
+        return table.tableauOffset > 0 ? std::min(dy / table.tableauOffset, cards - 1) : cards - 1;
+    }
+}
+
 class Deck {
 private:
     std::vector<Pile> tableaus;
@@ -440,45 +802,40 @@ private:
                 card.setSuit(static_cast<Suit>(i));
                 card.setRank(j + 1);
                 card.setVisible(false);
+                cardStore.push_back(card); // faces come from the atlas by card id
 
-                SDL_Texture* texture = SDLW::loadTexture(SDLW::getCardPath(card.getSuit(), card.getRank()));
-                if (!texture) {
-                    std::cerr << "Error loading texture for suit " << static_cast<int>(card.getSuit()) 
-                              << " and rank " << card.getRank() << std::endl;
-                    gStatus = GameStatus::TextureLoadError;
-                    return;
-                }
-                card.setTexture(texture);
-                cardStore.push_back(card);
             }
         }
     }
 
     void initStock() {
-        stock.setAlignment(Alignment::Horizontal);
-        for (const Card& card : cardStore) {
-            stock.addCard(const_cast<Card*>(&card)); // Ensure we use the correct reference
-        }
+        stock.setAlignment(Alignment::Horizontal); // cards go in with the deal
     }
 
     void initWaste() {
     	waste.setAlignment(Alignment::Horizontal);
     }
 
-    void shuffleStock() {
-        std::shuffle(stock.begin(), stock.end(), std::default_random_engine(static_cast<unsigned int>(std::time(0))));
-    }
+    void dealFromEngine() { // the engine owns the deal, the piles just point at cardStore in the same order
+        if (cardStore.size() != Klondike::NO_OF_CARDS) {
+            std::cerr << "cardStore incomplete, cannot deal" << std::endl;
+            gStatus = GameStatus::DeckInitError;
+            return;
+        }
+        Klondike::State state;
+        Klondike::deal(state, nextDealSeed);
+        LOG_INFO("Dealing game #", nextDealSeed);
+        nextDealSeed++; // Quit -> Play gets the next deal, still reproducible from the first one
 
-    void transferToTableaus() {
+        for (int i = 0; i < state.stockSize(); ++i) {
+            stock.addCard(&cardStore[state.stockCard(i)]);
+        }
         for (int i = 0; i < no_of_tableaus; ++i) {
             tableaus[i].setAlignment(Alignment::Vertical);
-            for (int j = 0; j <= i; ++j) {
-                Card* card_ptr = stock.top();
-                stock.removeCard();
-                tableaus[i].addCard(const_cast<Card*>(card_ptr));
-                if (j == i) {
-                    const_cast<Card*>(card_ptr)->setVisible(true);
-                }
+            for (int j = 0; j < state.tableauSize(i); ++j) {
+                Card* card_ptr = &cardStore[state.tableauCard(i, j)];
+                card_ptr->setVisible(state.isFaceUp(i, j));
+                tableaus[i].addCard(card_ptr);
             }
         }
     }
@@ -499,63 +856,55 @@ private:
         initStock();
         initWaste();
         initFoundations();
-        shuffleStock();
-        transferToTableaus();
+        dealFromEngine();
         // makeRemainderStockVisible();
     }
 
-    bool setCardBackTexture() {
-        Pile::cardBackTexture = SDLW::loadTexture(SDLW::backTexturePath);
-        if (!Pile::cardBackTexture) {
-            std::cerr << "Error in loading card back texture: " << SDL_GetError() << std::endl;
+    SDLW::CardBatch batch; // the whole board, rebuilt and drawn in one call by drawAllPiles()
+
+    bool buildAtlas() { // only the first Deck of the process builds it, later ones reuse the cached one
+        if (!SDLW::TextureCache::atlas()) {
+            gStatus = GameStatus::TextureLoadError;
             return false;
         }
         return true;
     }
 
-    void destroyCardBackTexture() {
-        SDL_DestroyTexture(Pile::cardBackTexture);
-        Pile::cardBackTexture = nullptr;
-    }
-
-    void destroyAllTextures() {
-        for (Card& card : cardStore) {
-            SDL_DestroyTexture(card.getTexture());
-        }
-        destroyCardBackTexture();
-    }
-
     void manageStockWasteDimensions() {
-        stock.setPosition(DeckFormulae::getStockX(), DeckFormulae::getStockY());
+        const Layout::Table& layout = Layout::table;
+        stock.setPosition(layout.stock.x, layout.stock.y);
         stock.setOffset(1); // TENTATIVE
-        stock.setCardDimensions(DeckFormulae::getGlobalCardW(), DeckFormulae::getGlobalCardH());
+        stock.setCardDimensions(layout.cardW, layout.cardH);
         stock.setPileRect();
 
-        waste.setPosition(DeckFormulae::getWasteX(), DeckFormulae::getWasteY());
+        waste.setPosition(layout.waste.x, layout.waste.y);
         waste.setOffset(1); // TENTATIVE
-        waste.setCardDimensions(DeckFormulae::getGlobalCardW(), DeckFormulae::getGlobalCardH());
+        waste.setCardDimensions(layout.cardW, layout.cardH);
         waste.setPileRect();
     }
 
     void manageFoundationDimensions() {
+        const Layout::Table& layout = Layout::table;
         for (int i = 0; i < no_of_suits; ++i) {
-            foundations[i].setPosition(DeckFormulae::getFoundationX(i), DeckFormulae::getFoundationY(i));
+            foundations[i].setPosition(layout.foundations[i].x, layout.foundations[i].y);
             foundations[i].setOffset(1); // TENTATIVE
-            foundations[i].setCardDimensions(DeckFormulae::getGlobalCardW(), DeckFormulae::getGlobalCardH());
+            foundations[i].setCardDimensions(layout.cardW, layout.cardH);
             foundations[i].setPileRect();
         }
     }
 
     void manageTableauDimensions() {
+        const Layout::Table& layout = Layout::table;
         for (int i = 0; i < no_of_tableaus; ++i) {
-            tableaus[i].setPosition(DeckFormulae::getTableauX(i), DeckFormulae::getTableauY(i));
-            tableaus[i].setOffset(DeckFormulae::getTableauOffset());
-            tableaus[i].setCardDimensions(DeckFormulae::getGlobalCardW(), DeckFormulae::getGlobalCardH());
+            tableaus[i].setPosition(layout.tableaus[i].x, layout.tableaus[i].y);
+            tableaus[i].setOffset(layout.tableauOffset);
+            tableaus[i].setCardDimensions(layout.cardW, layout.cardH);
             tableaus[i].setPileRect();
         }
     }
 
     void manageDimensions() {
+        Layout::rebuild();
         manageStockWasteDimensions();
         manageFoundationDimensions();
         manageTableauDimensions();
@@ -569,53 +918,53 @@ public:
     Deck(int suit_length, int no_of_suits, int no_of_tableaus)
         : suit_length(suit_length), no_of_suits(no_of_suits), no_of_tableaus(no_of_tableaus),
           tableaus(no_of_tableaus), foundations(no_of_suits) {
-        if (!setCardBackTexture()) {
-            std::cerr<<"Could not set card back texture in Deck constructor"<<std::endl;
+        if (!buildAtlas()) {
+            std::cerr<<"Could not build the card atlas in Deck constructor"<<std::endl;
         }
         initCards();
         initPiles();
         manageDimensions();
     }
 
-    ~Deck() {
-        destroyAllTextures();
-    }
-
-    void renderAllPiles() {
+    void layoutAllPiles() {
         for (auto& tableau : tableaus) {
-            tableau.renderAllCards();
+            tableau.layoutCards();
         }
         for (auto& foundation : foundations) {
-            foundation.renderAllCards();
+            foundation.layoutCards();
         }
-        stock.renderAllCards();
-        waste.renderAllCards();
-        std::cout<<"Does it renderAllPiles()?"<<std::endl;
+        stock.layoutCards();
+        waste.layoutCards();
     }
 
-    void drawAllPiles() {
-        for (auto& tableau : tableaus) {
-            SDLW::drawToWindow(tableau.getPileTexture(), tableau.getPileRect());
-        }
-        for (auto& foundation : foundations) {
-            SDLW::drawToWindow(foundation.getPileTexture(), foundation.getPileRect());
-        }
-        SDLW::drawToWindow(stock.getPileTexture(), stock.getPileRect());
-        SDLW::drawToWindow(waste.getPileTexture(), waste.getPileRect());
+    void drawAllPiles() { // one SDL_RenderGeometry call for every card on the board
+        drawPilesIn(nullptr);
     }
 
-    void renderPileAgain(Pile& pile) { // this should be used instead
-    	pile.recomputeAndRender();
+    void drawPilesIn(const SDL_Rect* area) { // only the piles touching area (all of them for nullptr), still one call
+        batch.clear();
+        auto add = [this, area](const Pile& pile) {
+            const SDL_Rect drawn = pile.getDrawnRect();
+            if (!area || SDL_HasIntersection(&drawn, area)) pile.addToBatch(batch);
+        };
+        for (const auto& tableau : tableaus) {
+            add(tableau);
+        }
+        for (const auto& foundation : foundations) {
+            add(foundation);
+        }
+        add(stock);
+        add(waste);
+        batch.draw();
     }
 
-    void redrawPile(Pile& pile) { // this is really not used anywhere
-        pile.renderAllCards();
-        drawAllPiles();
+    void relayoutPile(Pile& pile) {
+    	pile.recomputeLayout();
     }
 
     void onResize() {
         manageDimensions();
-        renderAllPiles();
+        layoutAllPiles();
     }
 
     Pile& getTableau(int index) { return tableaus.at(index); }
@@ -643,7 +992,7 @@ public:
 	Stack(Pile& originPile) : originPile(originPile), stackTexture(nullptr), x(originPile.getX()), y(originPile.getY()) {}
 	~Stack() {
 		if (!empty()) returnStackToOriginPile();
-		if (stackTexture) SDL_DestroyTexture(stackTexture);
+		if (stackTexture) SDLW::TargetPool::release(stackTexture);
 	}
 
 	int getX() const { return x; }
@@ -652,6 +1001,7 @@ public:
 	bool empty() const { return cards.empty(); }
 	int getStackTextureHeight() const { return (originPile.getOffset() * (size() - 1)) + originPile.getCardHeight(); }
 	SDL_Rect getStackRect() const { return {x, y, originPile.getCardWidth(), getStackTextureHeight()}; }
+	SDL_Rect getStackSourceRect() const { return {0, 0, originPile.getCardWidth(), getStackTextureHeight()}; } // the used corner of the pooled texture
 	SDL_Texture* getStackTexture() const { return stackTexture; }
 
 	Card* top() { return empty() ? nullptr : cards.back(); }
@@ -666,9 +1016,9 @@ public:
 
 	void updateStackTexture() {
     	if (stackTexture) {
-    		SDL_DestroyTexture(stackTexture); stackTexture = nullptr;
+    		SDLW::TargetPool::release(stackTexture); stackTexture = nullptr;
     	}
-    	stackTexture = SDL_CreateTexture(gRenderer, SDL_PIXELFORMAT_RGBA8888, SDL_TEXTUREACCESS_TARGET, originPile.getCardWidth(), getStackTextureHeight());
+    	stackTexture = SDLW::TargetPool::acquire(originPile.getCardWidth(), getStackTextureHeight());
     	if (!stackTexture) {
     		std::cerr<<"Error creating stack texture from "<<((originPile.isTableau())?"tableau":"non-tableau pile")<<std::endl;
     	}
@@ -741,6 +1091,7 @@ public:
 
 		int actualX = getX();
 
+		SDLW::CardBatch batch;
     	for (size_t i=0; i<size(); i++) {
     		Card* card = cards[i];
     		rect.y = i * originPile.getOffset();
@@ -748,20 +1099,22 @@ public:
     		int actualY = getY() + rect.y;
     		card->setRect({actualX, actualY, originPile.getCardWidth(), originPile.getCardHeight()});
 
-    		SDLW::drawToTexture(card->getTexture(), rect);
+    		batch.addCard(card->getAtlasCell(), rect);
     		// stacks can only contain visible cards, would check if visible when creating stack
     	}
+    	batch.draw();
+    	SDLW::setWindowTarget();
     }
 };
 
 namespace Statistics {
 	int total_score {0};
 
-	const int score_CardRevealedOnTableau {2};
-	const int score_CardDrawnFromStock {2};
-	const int score_CardPutOnFoundation {5};
-	const int score_CycleThroughStock {-2};
-	const int score_CardDrawnFromFoundation {-5};
+	const int score_CardRevealedOnTableau {Klondike::Score::CardRevealedOnTableau};
+	const int score_CardDrawnFromStock {Klondike::Score::CardDrawnFromStock};
+	const int score_CardPutOnFoundation {Klondike::Score::CardPutOnFoundation};
+	const int score_CycleThroughStock {Klondike::Score::CycleThroughStock};
+	const int score_CardDrawnFromFoundation {Klondike::Score::CardDrawnFromFoundation};
 
 	int getScore() { return total_score; }
 	void resetScore() { total_score = 0; }
@@ -774,7 +1127,7 @@ namespace Statistics {
 	void onCycleThroughStock() { addToScore(score_CycleThroughStock); }
 	void onCardDrawnFromFoundation() { addToScore(score_CardDrawnFromFoundation); }
 
-	void printScore() { std::cout<<"--- Current score is "<<total_score<<std::endl; }
+	void printScore() { LOG_INFO("--- Current score is ", total_score); }
 
 	// bools for targeting change
 	bool change_was_made_in_cycle = false;
@@ -787,6 +1140,7 @@ namespace Statistics {
 	bool checkGameLoseCondition() { return !getChangeMadeInCycle(); }
 	bool onCycleComplete() {
 		if (checkGameLoseCondition()) {
+			Klondike::Log::flush(); // the prompt below goes straight to the console, after whatever was logged
 			std::cout<<"You did not make any valid moves this time around and have reached end of cycle."<<std::endl; // no cards unveiled or drawn from stock/waste
 			std::cout<<"Continue game? Y or N"<<std::endl;
 			char tmp;
@@ -827,21 +1181,13 @@ namespace Logic {
     }
     bool foundation_CanStackCardOnCard(Card* upper_card, Card* bottom_card) {
     	if (memcheckCard(upper_card, "first - from foundation_canStackCardOnCard() -- rudimentary")) {
-    		if (!bottom_card) {
-    			return upper_card->getRank() == Card::Ace;
-    		} else {
-    			return upper_card->getSuit() == bottom_card->getSuit() && upper_card->getRank() == (bottom_card->getRank() + 1);
-    		}
+    		return Klondike::Rules::foundationCanStack(upper_card->getId(), bottom_card ? bottom_card->getId() : Klondike::NoCard);
     	}
     	return false;
     }
     bool tableau_CanStackCardOnCard(Card* upper_card, Card* bottom_card) {
     	if (memcheckCard(upper_card, "first - from tableau_canStackCardOnCard() -- rudimentary")) {
-    		if (!bottom_card) {
-    			return upper_card->getRank() == Card::King;
-    		} else {
-    			return upper_card->getColour() != bottom_card->getColour() && upper_card->getRank() == (bottom_card->getRank() - 1);
-    		}
+    		return Klondike::Rules::tableauCanStack(upper_card->getId(), bottom_card ? bottom_card->getId() : Klondike::NoCard);
     	}
     	return false;
     }
@@ -858,20 +1204,6 @@ namespace Logic {
     	return (stack.size() == 1) ? canMoveCardToFoundation(stack.bottom(), foundation) : false;
     }
 
-    // getters for mouse events
-    int getMaxTableauY(Deck& deck) {
-        int max_cards = 0; 
-        size_t idx = 0;  // Initialize index
-        for (size_t i = 0; i < deck.no_of_tableaus; i++) {
-            Pile& tableau = deck.getTableau(i);
-            if (tableau.size() > max_cards) {
-                max_cards = tableau.size();
-                idx = i;  // Store index of the tableau with the maximum cards
-            }
-        }
-        return deck.getTableau(idx).getY() + deck.getTableau(idx).getPileTextureHeight();  // Correct usage of idx
-    }
-
     // boolean checks for mouse events
     bool mouseOnCard(SDL_Point& mouse_point, Card* card_ptr) {
         if (!card_ptr) {
@@ -883,47 +1215,31 @@ namespace Logic {
     bool mouseOnPile(SDL_Point& mouse_point, Pile& pile) {
         return SDLW::mouseInRect(pile.getPileRect(), mouse_point);
     }
+    // all of these are lookups in Layout::table, no scanning over piles or cards
     bool mouseOnStock(SDL_Point& mouse_point, Deck& deck) {
-        return mouseOnPile(mouse_point, deck.getStock());
+        return Layout::topRowAt(mouse_point) == Layout::StockColumn;
     }
 
     bool mouseOnWaste(SDL_Point& mouse_point, Deck& deck) {
-        return mouseOnPile(mouse_point, deck.getWaste());
+        return Layout::topRowAt(mouse_point) == Layout::WasteColumn;
     }
     bool mouseOnTableauSpace(SDL_Point& mouse_point, Deck& deck) {
-        if (mouse_point.y >= deck.getTableau(0).getY() && mouse_point.y <= getMaxTableauY(deck)) {
-            Pile& last_tableau = deck.getTableau(deck.no_of_tableaus - 1);
-            if (mouse_point.x >= deck.getTableau(0).getX() && mouse_point.x <= last_tableau.getX() + last_tableau.getCardWidth()) {
-                return true;
-            }
-        }
-        return false; 
+        return Layout::tableauColumnAt(mouse_point) != Layout::NoColumn;
     }
     bool mouseOnFoundationSpace(SDL_Point& mouse_point, Deck& deck) { // Includes stock and waste
-        if (mouse_point.y >= deck.getStock().getY() && mouse_point.y <= deck.getStock().getY() + deck.getStock().getCardHeight()) {
-            Pile& last_foundation = deck.getFoundation(deck.no_of_suits - 1);
-            if (mouse_point.x >= deck.getStock().getX() && mouse_point.x <= last_foundation.getX() + last_foundation.getCardWidth()) {
-                return true;
-            }
-        }
-        return false;
+        return Layout::topRowAt(mouse_point) != Layout::NoColumn;
     }
     // size_t checks for mouse events
     int mouseOnWhichFoundation(SDL_Point& mouse_point, Deck& deck) {
-        for (size_t i = 0; i < deck.no_of_suits; i++) {
-            if (mouseOnPile(mouse_point, deck.getFoundation(i))) {
-                return static_cast<int>(i);  // Return index of the foundation if mouse is over it
-            }
-        }
-        return -1;  // Return -1 if no foundation is under the mouse
+        const int column = Layout::topRowAt(mouse_point);
+        return (column >= 0 && column < deck.no_of_suits) ? column : -1;  // -1 if no foundation is under the mouse
     }
 	int mouseOnWhichTableau(SDL_Point& mouse_point, Deck& deck) {
-	    for (size_t i = 0; i < deck.no_of_tableaus; i++) {
-	        if (mouseOnPile(mouse_point, deck.getTableau(i))) {
-	            return static_cast<int>(i);
-	        }
-	    }
-	    return -1;  // Return -1 if no tableau is under the mouse
+	    const int column = Layout::tableauColumnAt(mouse_point);
+	    if (column == Layout::NoColumn) return -1;
+	    Pile& tableau = deck.getTableau(column);
+	    const int cards = std::max(static_cast<int>(tableau.size()), 1); // an empty tableau still takes a card dropped on its slot
+	    return Layout::tableauRowAt(mouse_point, cards) != -1 ? column : -1;  // -1 if no tableau is under the mouse
 	}
 	/* int mouseOnWhichCardInTableauOld(SDL_Point& mouse_point, Pile& tableau) { // outdated function, does not position offset correctly
 	    for (size_t i = 0; i < tableau.size(); i++) {
@@ -934,18 +1250,13 @@ namespace Logic {
 	    return -1; // No card found
 	} */
 	int mouseOnWhichCardInTableau(SDL_Point& mouse_point, Pile& tableau) {
-		for (size_t i = tableau.size()-1; i >= 0 && tableau[i]->isVisible(); i--) {
-			if (mouseOnCard(mouse_point, tableau[i])) {
-				return static_cast<int>(i);
-			}
-		}
-		return -1;
+		const int idx = Layout::tableauRowAt(mouse_point, static_cast<int>(tableau.size()));
+		return (idx != -1 && tableau[idx]->isVisible()) ? idx : -1; // face-down cards can't be picked up
 	}
 }
 
-namespace Meta { // forward declaration: forward declared Meta functions for Operations
-	void loadCachedTexture();
-	void destroyCachedTexture();
+namespace Compositor { // forward declaration for Operations
+	void relayout(Pile& pile);
 }
 
 void quitGame(); // forward declaration for game quit operation handles
@@ -987,10 +1298,10 @@ namespace Operations {
 				stock.addCard(waste.top());
 				waste.removeCard();
 			}
-			std::cout<<"Transferred all from waste to stock"<<std::endl;
+			LOG_DEBUG("Transferred all from waste to stock");
 			return true;
 		} else {
-			std::cout<<"Quittin' game or something"<<std::endl;
+			LOG_INFO("Quittin' game or something");
 			quitGame();
 			return false;
 		}
@@ -1024,7 +1335,6 @@ namespace Operations {
 	void destroyStack() {
 		if (gStack) delete gStack;
 		gStack = nullptr;
-		Meta::destroyCachedTexture();
 	}
 	void actuallyRenderStack() {
 		gStack->updateStackTexture();
@@ -1037,9 +1347,8 @@ namespace Operations {
 	}
 	// if ChangeListener.size() ever stops being >2 we're doomed (or <0 too); well as long as it's Klondike it shouldn't...
 	void prepareCachedTexture(Pile& pile) { // groups together redundant stack creation preparations
-		pile.recomputeAndRender(); // render the pile the stack is created from before loading cached texture; fixed: use recomputeAndRender() than renderAllCards()
+		Compositor::relayout(pile); // the board layer without the lifted cards is the backdrop of the whole drag
 		actuallyRenderStack();
-		Meta::loadCachedTexture();
 	}
 	void createStackFromWaste(Pile& waste) { // THIS FOR WASTE
 		createStack(waste);
@@ -1063,12 +1372,12 @@ namespace Operations {
 
 	// down handlers:
 	void handleDownOnStock(SDL_Point& mp, Deck& deck) {
-		std::cout<<"Handle down on stock reached"<<std::endl;
+		LOG_DEBUG("Handle down on stock reached");
 		moveFromStockToWaste(deck.getStock(), deck.getWaste());
 	}
 	void handleDownOnWaste(SDL_Point& mp, Deck& deck) {
 		// selects single card to drag from waste
-		std::cout<<"Handle down on waste reached"<<std::endl;
+		LOG_DEBUG("Handle down on waste reached");
 		if (!deck.getWaste().empty()) {
 			createStackFromWaste(deck.getWaste());
 			setDragged(mp);
@@ -1079,7 +1388,7 @@ namespace Operations {
 	}
 	void handleDownOnFoundation(SDL_Point& mp, int foundation_idx, Deck& deck) {
 		// selects a card from foundation
-		std::cout<<"Handle down on foundation "<<foundation_idx<<" reached"<<std::endl;
+		LOG_DEBUG("Handle down on foundation ", foundation_idx, " reached");
 		Pile& foundation = deck.getFoundation(foundation_idx);
 
 		if (!foundation.empty()) {
@@ -1092,7 +1401,7 @@ namespace Operations {
 	}
 	void handleDownOnTableau(SDL_Point& mp, int tableau_idx, Deck& deck) {
 		// placeholder
-		std::cout<<"Handle down on tableau "<<tableau_idx<<" reached"<<std::endl;
+		LOG_DEBUG("Handle down on tableau ", tableau_idx, " reached");
 		Pile& tableau = deck.getTableau(tableau_idx);
 
 		if (!tableau.empty()) {
@@ -1119,7 +1428,7 @@ namespace Operations {
 	}
 	void handleUpOnFoundation(int idx, Deck& deck) {
 		// sees if stack is loadable to the clicked foundation
-		std::cout<<"Handle up on foundation "<<idx<<" reached"<<std::endl;
+		LOG_DEBUG("Handle up on foundation ", idx, " reached");
 
 		Pile& foundation = deck.getFoundation(idx);
 
@@ -1142,7 +1451,7 @@ namespace Operations {
 	}
 	void handleUpOnTableau(int idx, Deck& deck) {
 		// placeholder
-		std::cout<<"Handle up on tableau "<<idx<<" reached"<<std::endl;
+		LOG_DEBUG("Handle up on tableau ", idx, " reached");
 
 		Pile& tableau = deck.getTableau(idx);
 
@@ -1190,8 +1499,8 @@ namespace Operations {
 		if (dragged) {
 			gStack->setStackPosition(e.motion.x - drag_offset.x, e.motion.y - drag_offset.y);
 			gStack->updateStackCardsRects();
-			std::cout<<"Mouse motion is being handled"<<std::endl;
-			has_changed = true; // so that GameLoop draws stack and cachedTexture
+			LOG_DEBUG("Mouse motion is being handled");
+			has_changed = true; // so that GameLoop draws the board and the stack
 			return true;
 		}
 		return false;
@@ -1259,37 +1568,39 @@ namespace Meta {
 	int gameButtonHeight = 150;
 
 	bool initTextures() {
-	    titleTexture = SDLW::loadTexture("assets/title.png");
+	    SDLW::TextureCache::preload({"assets/title.png", "assets/woodsplash.png", "assets/home.png", "assets/play.png",
+	                                 "assets/settings.png", "assets/quit.png", "assets/return.png"});
+	    titleTexture = SDLW::TextureCache::get("assets/title.png");
 	    if (!titleTexture) {
 	        std::cerr << "Title texture load failure: " << SDL_GetError() << std::endl;
 	        return false;
 	    }
-	    backgroundTexture = SDLW::loadTexture("assets/woodsplash.png");
+	    backgroundTexture = SDLW::TextureCache::get("assets/woodsplash.png");
 	    if (!backgroundTexture) {
 	        std::cerr << "Background texture load failure: " << SDL_GetError() << std::endl;
 	        return false;
 	    }
-	    homeTexture = SDLW::loadTexture("assets/home.png");
+	    homeTexture = SDLW::TextureCache::get("assets/home.png");
 	    if (!homeTexture) {
 	        std::cerr << "Home texture load failure: " << SDL_GetError() << std::endl;
 	        return false;
 	    }
-	    playTexture = SDLW::loadTexture("assets/play.png");
+	    playTexture = SDLW::TextureCache::get("assets/play.png");
 	    if (!playTexture) {
 	        std::cerr << "Play texture load failure: " << SDL_GetError() << std::endl;
 	        return false;
 	    }
-	    settingsTexture = SDLW::loadTexture("assets/settings.png");
+	    settingsTexture = SDLW::TextureCache::get("assets/settings.png");
 	    if (!settingsTexture) {
 	        std::cerr << "Settings texture load failure: " << SDL_GetError() << std::endl;
 	        return false;
 	    }
-	    quitTexture = SDLW::loadTexture("assets/quit.png");
+	    quitTexture = SDLW::TextureCache::get("assets/quit.png");
 	    if (!quitTexture) {
 	        std::cerr << "Quit texture load failure: " << SDL_GetError() << std::endl;
 	        return false;
 	    }
-	    returnTexture = SDLW::loadTexture("assets/return.png");
+	    returnTexture = SDLW::TextureCache::get("assets/return.png");
 	    if (!returnTexture) {
 	        std::cerr << "Return texture load failure: " << SDL_GetError() << std::endl;
 	        return false;
@@ -1297,35 +1608,14 @@ namespace Meta {
 
 	    return true;
 	}
-	void closeTextures() {
-        if (titleTexture) {
-            SDL_DestroyTexture(titleTexture);
-            titleTexture = nullptr;
-        }
-        if (backgroundTexture) {
-            SDL_DestroyTexture(backgroundTexture);
-            backgroundTexture = nullptr;
-        }
-        if (homeTexture) {
-            SDL_DestroyTexture(homeTexture);
-            homeTexture = nullptr;
-        }
-        if (playTexture) {
-            SDL_DestroyTexture(playTexture);
-            playTexture = nullptr;
-        }
-        if (settingsTexture) {
-            SDL_DestroyTexture(settingsTexture);
-            settingsTexture = nullptr;
-        }
-        if (quitTexture) {
-            SDL_DestroyTexture(quitTexture);
-            quitTexture = nullptr;
-        }
-        if (returnTexture) {
-            SDL_DestroyTexture(returnTexture);
-            returnTexture = nullptr;
-        }
+	void closeTextures() { // the cache owns them, this only drops the references
+        titleTexture = nullptr;
+        backgroundTexture = nullptr;
+        homeTexture = nullptr;
+        playTexture = nullptr;
+        settingsTexture = nullptr;
+        quitTexture = nullptr;
+        returnTexture = nullptr;
     }
 
 	namespace mform {
@@ -1403,32 +1693,6 @@ namespace Meta {
 	    resetGameRects();
 	}
 
-	SDL_Texture* cachedTexture = nullptr;
-	void loadCachedTexture() { // loads and draws the cachedTexture, but nothing more
-		if (!gDeck) {
-			std::cerr<<"Deck object null when creating cachedTexture"<<std::endl;
-			return;
-		}
-		if (!cachedTexture) {
-			cachedTexture = SDL_CreateTexture(gRenderer, SDL_PIXELFORMAT_RGBA8888, SDL_TEXTUREACCESS_TARGET, scrWidth, scrHeight);
-			if (!cachedTexture) {
-				std::cerr<<"Unable to create cached texture"<<std::endl; return;
-			}
-			SDLW::setTarget(cachedTexture);
-	    	SDLW::renderClear();
-
-	    	SDLW::drawToTexture(backgroundTexture, backgroundRect);
-
-	    	gDeck->drawAllPiles(); // a hack, but one that's important
-	    	// does not draw buttons when dragging
-		}
-	}
-	void destroyCachedTexture() {
-		if (cachedTexture) {
-			SDL_DestroyTexture(cachedTexture);
-			cachedTexture = nullptr;
-		}
-	}
 	void drawBackground() {
 		SDLW::drawToWindow(backgroundTexture, backgroundRect);
 	}
@@ -1437,14 +1701,99 @@ namespace Meta {
 		SDLW::drawToWindow(settingsTexture, gSettingsRect);
 		SDLW::drawToWindow(quitTexture, quitRect);
 	}
-	void drawEverything() {
-		drawBackground();
+}
+
+// Retained layers for the game screen, both window-sized targets from the pool:
+//  - background: the woodsplash and the game buttons, only drawn again after a resize or for a new game
+//  - board: background plus every pile; a changed pile only repaints the rects it damaged (old and new extent)
+//  - overlay: the dragged stack, put over the board when presenting and never baked in
+// A frame is one board copy (plus the stack) however much is on the table.
+namespace Compositor {
+	SDL_Texture* background = nullptr;
+	SDL_Texture* board = nullptr;
+	bool valid = false;
+	SDL_Rect damage = {0, 0, 0, 0};
+
+	SDL_Rect screenRect() { return {0, 0, scrWidth, scrHeight}; }
+
+	void invalidate() { valid = false; } // window resized, new game, targets lost
+
+	void release() {
+		if (background) SDLW::TargetPool::release(background);
+		if (board) SDLW::TargetPool::release(board);
+		background = nullptr;
+		board = nullptr;
+		valid = false;
+	}
+
+	void addDamage(const SDL_Rect& rect) {
+		if (SDL_RectEmpty(&damage)) damage = rect;
+		else SDL_UnionRect(&damage, &rect, &damage);
+	}
+
+	void relayout(Pile& pile) { // use this instead of Pile::recomputeLayout() on the game screen
+		addDamage(pile.getDrawnRect());
+		pile.recomputeLayout();
+		addDamage(pile.getDrawnRect());
+	}
+
+	bool rebuild() {
+		release();
+		background = SDLW::TargetPool::acquire(scrWidth, scrHeight);
+		board = SDLW::TargetPool::acquire(scrWidth, scrHeight);
+		if (!background || !board) {
+			std::cerr<<"Unable to create the compositor layers"<<std::endl;
+			return false;
+		}
+		SDL_Rect screen = screenRect();
+
+		SDLW::setTarget(background);
+		SDLW::renderClear();
+		Meta::drawBackground();
+		Meta::drawGameButtons();
+
+		SDLW::setTarget(board);
+		SDL_RenderCopy(gRenderer, background, &screen, &screen);
+		gDeck->drawAllPiles();
+
+		SDLW::setWindowTarget();
+		damage = {0, 0, 0, 0};
+		valid = true;
+		return true;
+	}
+
+	void repaintDamage() {
+		SDL_Rect screen = screenRect();
+		SDL_Rect area;
+		if (!SDL_RectEmpty(&damage) && SDL_IntersectRect(&damage, &screen, &area)) {
+			SDLW::setTarget(board);
+			SDL_RenderSetClipRect(gRenderer, &area);
+			SDL_RenderCopy(gRenderer, background, &area, &area); // the background layer is opaque, this overwrites
+			gDeck->drawPilesIn(&area);
+			SDL_RenderSetClipRect(gRenderer, nullptr);
+			SDLW::setWindowTarget();
+		}
+		damage = {0, 0, 0, 0};
+	}
+
+	void present() {
 		if (!gDeck) {
-			std::cerr<<"Deck invalid for drawEverything()"<<std::endl;
+			std::cerr<<"Deck invalid for Compositor::present()"<<std::endl;
+			return;
+		}
+		if (!valid) {
+			if (!rebuild()) return;
 		} else {
-			gDeck->drawAllPiles();
+			repaintDamage();
+		}
+		SDL_Rect screen = screenRect();
+		SDLW::setWindowTarget();
+		SDLW::renderClear(); // the letterbox bars while the window doesn't match the logical size
+		SDLW::drawPartToWindow(board, screen, screen);
+		if (dragged && gStack) {
+			SDLW::drawPartToWindow(gStack->getStackTexture(), gStack->getStackSourceRect(), gStack->getStackRect());
 		}
-		drawGameButtons();
+		SDLW::renderPresent();
 	}
 }
 
@@ -1458,16 +1807,17 @@ void resetRenderLogicSize() {
 
 // ---- GAME LOOP HERE ----
 
-void resetGameSizes() { // handled by resizeHandler
+void resetGameSizes() { // handled by applyResize
 	Meta::resetGameButtons();
     gDeck->onResize();
+    Compositor::invalidate();
 }
-void resizeHandler(int new_width, int new_height) {
+void applyResize(int new_width, int new_height) { // the actual rebuild, once the size settled
     scrWidth = new_width;
     scrHeight = new_height;
     resetRenderLogicSize();
 
-    std::cout<<"New scrWidth: "<<scrWidth<<" and scrHeight "<<scrHeight<<std::endl;
+    LOG_DEBUG("New scrWidth: ", scrWidth, " and scrHeight ", scrHeight);
 
     // Reset button sizes and positions based on the current screen
     switch (screen) {
@@ -1487,6 +1837,30 @@ void resizeHandler(int new_width, int new_height) {
     has_changed = true;
 }
 
+void resizeHandler(int new_width, int new_height) {
+    has_changed = true; // present again right away, the renderer scales the current logical size to the new window
+    if (fixedLogicalSize) return;
+    pendingResize.pending = true;
+    pendingResize.width = new_width;
+    pendingResize.height = new_height;
+    pendingResize.since = SDL_GetTicks();
+}
+
+// ms until a pending resize settles (0 if it already has), or `idle` if none is pending
+int resizeWaitMs(int idle) {
+    if (!pendingResize.pending) return idle;
+    const Uint32 elapsed = SDL_GetTicks() - pendingResize.since;
+    return elapsed >= resizeSettleMs ? 0 : static_cast<int>(resizeSettleMs - elapsed);
+}
+
+void applySettledResize() {
+    if (!pendingResize.pending || resizeWaitMs(0) > 0) return;
+    pendingResize.pending = false;
+    if (pendingResize.width != scrWidth || pendingResize.height != scrHeight) {
+        applyResize(pendingResize.width, pendingResize.height);
+    }
+}
+
 enum class GamePerspective {
 	Home,
 	Settings,
@@ -1496,7 +1870,7 @@ enum class GamePerspective {
 GamePerspective gPersp = GamePerspective::Nothing;
 
 void quitGame() {
-	if (Meta::cachedTexture) Meta::destroyCachedTexture();
+	Compositor::release();
 	if (gDeck) delete gDeck;
 	if (dragged) Operations::clearDragged();
 	gDeck = nullptr;
@@ -1515,8 +1889,9 @@ void GameLoop() {
     	gDeck = new Deck(DEFAULT_SUIT_LENGTH, DEFAULT_NO_OF_SUITS, DEFAULT_NO_OF_TABLEAUS);
     	if (gDeck) {
     		game_is_running = true;
-    		gDeck->renderAllPiles();
-    		std::cout<<"Game started successfully or whatever"<<std::endl;
+    		gDeck->layoutAllPiles();
+    		Compositor::invalidate();
+    		LOG_INFO("Game started successfully or whatever");
     	} else {
     		std::cerr<<"Could not start a new game"<<std::endl;
     		gStatus = GameStatus::DeckInitError;
@@ -1524,24 +1899,11 @@ void GameLoop() {
     }
 
     if (dragged && has_changed) {
-    	SDLW::setWindowTarget();
-    	SDLW::renderClear();
-
-    	if (!Meta::cachedTexture) {
-    		std::cerr<<"cachedTexture does not exist when drawing in GameLoop"<<std::endl;
-    	} else {
-    		SDLW::drawToWindow(Meta::cachedTexture, {0, 0, scrWidth, scrHeight});
-    		std::cout<<"Window has been drawn while dragging"<<std::endl;
-    	}
     	if (!gStack) {
     		std::cerr<<"gStack is null when drawing in GameLoop"<<std::endl;
-    	} else {
-    		SDLW::drawToWindow(gStack->getStackTexture(), gStack->getStackRect());
-    		const SDL_Rect& rect = gStack->getStackRect();
-    		std::cout<<"Stack has been drawn while dragging with dimensions "<<rect.x<<","<<rect.y<<","<<rect.w<<","<<rect.h<<std::endl;
     	}
-
-    	SDLW::renderPresent();
+    	Compositor::present(); // board layer as it was when the drag started, stack on top
+    	LOG_DEBUG("Window has been drawn while dragging");
 
     	has_changed = false;
 
@@ -1555,55 +1917,54 @@ void GameLoop() {
     	for (int i=0; i<changeListener.size(); i++) {
     		switch (changeListener[i]) {
     		case ChangeListener::Stock:
-    			gDeck->renderPileAgain(gDeck->getStock());
+    			Compositor::relayout(gDeck->getStock());
     			// change_idx[0] = change_idx[1]; // extra hacky
     			break;
     		case ChangeListener::Waste:
-    			gDeck->renderPileAgain(gDeck->getWaste());
+    			Compositor::relayout(gDeck->getWaste());
     			// change_idx[0] = change_idx[1]; // extra hacky
     			break;
     		case ChangeListener::Tableau:
-    			// gDeck->renderPileAgain(gDeck->getTableau(change_idx[i]));
+    			// gDeck->relayoutPile(gDeck->getTableau(change_idx[i]));
     			// change_idx[0] = change_idx[1]; // hacky
-    			gDeck->renderPileAgain(gDeck->getTableau(changeIDXs[i])); // hacky? not anymore 😈
+    			Compositor::relayout(gDeck->getTableau(changeIDXs[i])); // hacky? not anymore 😈
     			break;
     		case ChangeListener::Foundation:
-    			// gDeck->renderPileAgain(gDeck->getFoundation(change_idx[0]));
+    			// gDeck->relayoutPile(gDeck->getFoundation(change_idx[0]));
     			// change_idx[0] = change_idx[1];
-    			gDeck->renderPileAgain(gDeck->getFoundation(changeIDXs[i]));
+    			Compositor::relayout(gDeck->getFoundation(changeIDXs[i]));
     			break;
     		}
     	}
     	// changeListener.clear(); change_idx[0] = 0; change_idx[1] = 0; // all change_idx's are hacky
     	clearChangeListener();
 
-    	SDLW::setWindowTarget();
-    	SDLW::renderClear();
-
-    	Meta::drawBackground();
-
-    	gDeck->drawAllPiles();
+    	Compositor::present(); // repaints only what those piles covered before and after
 
-    	Meta::drawGameButtons();
-
-    	SDLW::renderPresent();
-
-    	std::cout<<"changeListener handled"<<std::endl;
+    	LOG_DEBUG("changeListener handled");
 
     	has_changed = false;
 
     } else if (has_changed && changeListener.empty()) {
-    	SDLW::setWindowTarget();
-    	SDLW::renderClear();
-    	Meta::drawEverything();
+    	Compositor::present(); // rebuilds the layers first if they were invalidated
 
-    	std::cout<<"does it get to init render and draw in gameLoop?"<<std::endl;
-    	SDLW::renderPresent();
+    	LOG_DEBUG("does it get to init render and draw in gameLoop?");
 
     	has_changed = false;
     }
 
+    // a drag floods motion events; only the latest one per frame moves the stack
+    // (it's applied before any other event so the order of events still holds)
+    SDL_Event motion;
+    bool motion_pending = false;
     while (SDL_PollEvent(&e)!=0) {
+    	if (dragged && e.type == SDL_MOUSEMOTION) {
+    		motion = e;
+    		motion_pending = true;
+    		continue;
+    	}
+    	if (motion_pending && gDeck) Operations::mouseMotionHandled(motion, *gDeck);
+    	motion_pending = false;
     	// to handle EVERYTHINg
     	if (e.type == SDL_QUIT) {
     		if (gDeck) delete gDeck;
@@ -1613,6 +1974,9 @@ void GameLoop() {
     		if (e.window.event == SDL_WINDOWEVENT_SIZE_CHANGED) {
     			resizeHandler(e.window.data1, e.window.data2);
     		}
+    	} else if (e.type == SDL_RENDER_TARGETS_RESET || e.type == SDL_RENDER_DEVICE_RESET) {
+    		Compositor::invalidate(); // the layers' contents are gone
+    		has_changed = true;
     	} else if (e.type == SDL_MOUSEBUTTONDOWN) {
     		/* if (Operations::mouseDownHandled(e, *gDeck)) {
     			// game operations closure here for mousedown
@@ -1661,10 +2025,9 @@ void GameLoop() {
     			gPersp = GamePerspective::Nothing;
     			has_changed = true;
     		}
-    	} else if (dragged && e.type == SDL_MOUSEMOTION) {
-    		Operations::mouseMotionHandled(e, *gDeck);
     	}
     }
+    if (motion_pending && gDeck) Operations::mouseMotionHandled(motion, *gDeck);
 }
 
 enum class SettingsPerspective {
@@ -1769,7 +2132,14 @@ void HomeLoop() {
 
     	SDLW::renderPresent();
     	has_changed = false;
+
+    	static bool first_frame = true;
+    	if (first_frame) {
+    		LOG_INFO("Home screen shown ", msSinceLaunch(), " ms after launch");
+    		first_frame = false;
+    	}
     }
+    if (SDLW::Preload::ready()) SDLW::TextureCache::atlas(); // upload as soon as it's composed, not on Play
 
     while (SDL_PollEvent(&e)!=0) {
     	if (e.type == SDL_QUIT) {
@@ -1826,22 +2196,30 @@ InitStatus init() {
     	std::cerr<<"Can't initialise SDL Image: "<<SDL_GetError()<<std::endl;
     	return InitStatus::ErrorInitIMG;
     }
+    SDL_SetHint(SDL_HINT_RENDER_SCALE_QUALITY, "linear"); // scaled frames and cards filter instead of dropping pixels
     gWindow = SDL_CreateWindow("asolGUI", SDL_WINDOWPOS_CENTERED, SDL_WINDOWPOS_CENTERED, scrWidth, scrHeight, SDL_WINDOW_SHOWN | SDL_WINDOW_RESIZABLE);
     if (!gWindow) {
     	std::cerr<<"Could not create SDL Window: "<<SDL_GetError()<<std::endl;
     	return InitStatus::ErrorCreatingWindow;
     }
-    gRenderer = SDL_CreateRenderer(gWindow, -1, SDL_RENDERER_ACCELERATED);
+    gRenderer = SDL_CreateRenderer(gWindow, -1, SDL_RENDERER_ACCELERATED | (frameRateCap > 0 ? 0 : SDL_RENDERER_PRESENTVSYNC));
     if (!gRenderer) {
     	std::cerr<<"Could not create game renderer: "<<SDL_GetError()<<std::endl;
     	return InitStatus::ErrorCreatingRenderer;
     }
     resetRenderLogicSize();
 
+    if (SDLW::assetPack.open(packPath)) {
+    	LOG_INFO("Using asset pack ", packPath, " (", SDLW::assetPack.count(), " images)");
+    } else if (packPathGiven) {
+    	std::cerr<<"Can't use asset pack "<<packPath<<", decoding the PNGs instead"<<std::endl;
+    }
+
     if (!Meta::initTextures()) {
     	std::cerr<<"Could not load the meta textures"<<std::endl;
     	return InitStatus::ErrorLoadingMetaTextures;
     }
+    SDLW::Preload::start(); // cards decode while Home is showing
 
     // for error logging speedup
     std::ios_base::sync_with_stdio(false);
@@ -1851,6 +2229,9 @@ InitStatus init() {
 
 void close() {
 	Meta::closeTextures();
+	SDLW::TextureCache::clear();
+	SDLW::assetPack.close(); // nothing points into it once the textures are gone
+	SDLW::TargetPool::clear();
 	if (gRenderer) {
 		SDL_DestroyRenderer(gRenderer);
 		gRenderer = nullptr;
@@ -1861,10 +2242,52 @@ void close() {
 	}
 	IMG_Quit();
 	SDL_Quit();
-	std::cout<<"Close finished successfully"<<std::endl;
+	LOG_INFO("Close finished successfully");
+	Klondike::Log::shutdown();
+}
+
+void parseArgs(int argc, char* argv[]) {
+	std::random_device rd;
+	nextDealSeed = (static_cast<std::uint64_t>(rd()) << 32) ^ rd();
+
+	for (int i = 1; i < argc; i++) {
+		std::string arg = argv[i];
+		if (arg == "--seed" && i + 1 < argc) {
+			nextDealSeed = std::strtoull(argv[++i], nullptr, 10);
+		} else if (arg == "--logical" && i + 1 < argc) {
+			int width = 0, height = 0;
+			if (std::sscanf(argv[++i], "%dx%d", &width, &height) == 2 && width > 0 && height > 0) {
+				scrWidth = width;
+				scrHeight = height;
+				fixedLogicalSize = true;
+			} else {
+				std::cerr<<"Bad --logical "<<argv[i]<<", expected WxH"<<std::endl;
+			}
+		} else if (arg == "--fps" && i + 1 < argc) {
+			frameRateCap = std::max(0, std::atoi(argv[++i]));
+		} else if (arg == "--pack" && i + 1 < argc) {
+			packPath = argv[++i];
+			packPathGiven = true;
+		} else if (arg == "--serve" && i + 1 < argc) {
+			serveOptions.name = argv[++i];
+		} else if (arg == "--envs" && i + 1 < argc) {
+			serveOptions.envs = std::atoi(argv[++i]);
+		} else if (arg == "--threads" && i + 1 < argc) {
+			serveOptions.threads = std::atoi(argv[++i]);
+		} else if (arg == "--slots" && i + 1 < argc) {
+			serveOptions.slots = std::atoi(argv[++i]);
+		} else {
+			std::cerr<<"Unknown argument: "<<arg<<" (usage: solitaire [--seed N] [--fps N] [--logical WxH] [--pack FILE] [--serve NAME [--envs N] [--threads N] [--slots N]])"<<std::endl;
+		}
+	}
 }
 
 int main(int argc, char* argv[]) {
+    parseArgs(argc, argv);
+    // training runs never touch SDL
+    if (!serveOptions.name.empty()) {
+        return Klondike::serveEnvs(serveOptions.name, serveOptions.envs, serveOptions.threads, serveOptions.slots, nextDealSeed);
+    }
     InitStatus initStatus = init();
 
     if (initStatus == InitStatus::Success) {
@@ -1873,18 +2296,18 @@ int main(int argc, char* argv[]) {
         Meta::resetHomeButtons();
 
         while (!quit) {
+            // nothing to draw: sleep until input arrives (the loops then poll it) instead of spinning
+            if (!has_changed) SDL_WaitEventTimeout(nullptr, resizeWaitMs(idleWaitMs));
+            applySettledResize();
             switch (screen) {
                 case Screen::Game:
                     GameLoop();
-                    SDL_Delay(1);
                     break;
                 case Screen::Settings:
                     SettingsLoop();
-                    SDL_Delay(1);
                     break;
                 default:
                     HomeLoop();
-                    SDL_Delay(1);
                     break;
             }
         }
@@ -0,0 +1,81 @@
+// Headless engine benchmark, no SDL needed:
+//   g++ -std=c++17 -O2 -pthread -I. tools/bench.cpp -o bench && ./bench [envs] [steps]
+
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <random>
+#include <thread>
+#include <vector>
+
+#include "engine/envbatch.hpp"
+
+namespace {
+    using Clock = std::chrono::steady_clock;
+
+    double seconds(Clock::time_point since) { return std::chrono::duration<double>(Clock::now() - since).count(); }
+
+    void benchDeal(int deals) {
+        Klondike::State state;
+        unsigned checksum = 0; // keeps the deals from being optimised away
+        Clock::time_point start = Clock::now();
+        for (int i = 0; i < deals; ++i) {
+            Klondike::deal(state, static_cast<std::uint64_t>(i));
+            checksum += state.tableauTop(0);
+        }
+        std::printf("deal()                        : %12.0f deals/s (checksum %u)\n", deals / seconds(start), checksum);
+    }
+
+    void benchReset(int envs, int rounds, int threads) {
+        Klondike::EnvBatch batch(envs, threads, 1);
+        Clock::time_point start = Clock::now();
+        for (int r = 0; r < rounds; ++r) batch.reset();
+        std::printf("EnvBatch::reset() %6d envs %2d threads: %12.0f env resets/s\n",
+                    envs, batch.threads(), static_cast<double>(envs) * rounds / seconds(start));
+    }
+
+    // times only EnvBatch::step() with masks and observations on, the random policy runs outside the clock
+    void benchEnvBatch(int envs, int steps, int threads) {
+        Klondike::EnvBatch batch(envs, threads, 1);
+        std::vector<std::int32_t> actions(envs);
+        std::vector<float> rewards(envs);
+        std::vector<std::uint8_t> dones(envs);
+        std::vector<std::uint8_t> masks(static_cast<std::size_t>(envs) * Klondike::ACTION_COUNT);
+        std::vector<std::uint8_t> obs(static_cast<std::size_t>(envs) * Klondike::OBS_SIZE);
+        Klondike::EnvBatch::Outputs out;
+        out.rewards = rewards.data();
+        out.dones = dones.data();
+        out.masks = masks.data();
+        out.obs = obs.data();
+        std::int32_t legal[Klondike::MAX_LEGAL_MOVES];
+        std::mt19937 rng(7);
+
+        double stepping = 0.0;
+        long long finished = 0;
+        for (int s = 0; s < steps; ++s) {
+            for (int env = 0; env < envs; ++env) {
+                const int count = Klondike::legalActions(batch.state(env), legal);
+                actions[env] = count ? legal[rng() % count] : Klondike::Action::Draw;
+            }
+            Clock::time_point start = Clock::now();
+            batch.step(actions.data(), out);
+            stepping += seconds(start);
+            for (int env = 0; env < envs; ++env) finished += dones[env];
+        }
+        std::printf("EnvBatch %6d envs %2d threads: %12.0f steps/s (%lld episodes finished)\n",
+                    envs, batch.threads(), static_cast<double>(envs) * steps / stepping, finished);
+    }
+}
+
+int main(int argc, char* argv[]) {
+    const int envs = (argc > 1) ? std::atoi(argv[1]) : 4096;
+    const int steps = (argc > 2) ? std::atoi(argv[2]) : 200;
+    const int cores = std::max(1u, std::thread::hardware_concurrency());
+
+    benchDeal(1000000);
+    benchReset(envs, 100, cores);
+    for (int threads = 1; threads <= cores; threads *= 2) benchEnvBatch(envs, steps, threads);
+    if ((cores & (cores - 1)) != 0) benchEnvBatch(envs, steps, cores);
+    return 0;
+}
@@ -0,0 +1,105 @@
+// Headless consistency check of the engine, no SDL needed:
+//   g++ -std=c++17 -O2 -I. tools/check.cpp -o check && ./check [deals] [first_seed]
+// Plays random legal moves through each deal and checks every position on the way:
+//  - moves: legalMoves() gives exactly the action ids isLegal() accepts (brute force over all ACTION_COUNT ids),
+//    without duplicates, and every legal move survives actionOf() -> moveOf()
+//  - keys: the incrementally updated hash() and canonicalHash() equal a full rehash()
+//  - undo: apply() then undo() of every legal move gives back the exact bytes of the position
+// Reports the first few failures; the exit code is 1 if there was any.
+
+#include <array>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <random>
+
+#include "engine/actions.hpp"
+
+namespace {
+    constexpr int MaxMovesPerDeal = 1000;
+    constexpr int MaxReports = 10;
+
+    int failures = 0;
+
+    void fail(unsigned seed, int ply, const char* what, int action) {
+        if (++failures <= MaxReports) std::fprintf(stderr, "deal %u, move %d: %s (action %d)\n", seed, ply, what, action);
+    }
+
+    bool sameMove(const Klondike::Move& a, const Klondike::Move& b) {
+        return a.kind == b.kind && a.from == b.from && a.to == b.to && a.count == b.count;
+    }
+
+    void checkMoves(const Klondike::State& state, const Klondike::MoveList& moves, unsigned seed, int ply) {
+        std::array<bool, Klondike::ACTION_COUNT> listed {};
+        for (const Klondike::Move& move : moves) {
+            const int action = Klondike::actionOf(move);
+            if (!Klondike::isValidAction(action)) {
+                fail(seed, ply, "legal move without an action id", action);
+                continue;
+            }
+            if (listed[action]) fail(seed, ply, "legalMoves() lists an action twice", action);
+            listed[action] = true;
+            if (!sameMove(Klondike::moveOf(action), move)) fail(seed, ply, "moveOf(actionOf(move)) != move", action);
+        }
+        for (int action = 0; action < Klondike::ACTION_COUNT; ++action) {
+            if (Klondike::isLegal(state, Klondike::moveOf(action)) != listed[action]) {
+                fail(seed, ply, listed[action] ? "legalMoves() lists a move isLegal() rejects" : "legalMoves() misses a legal move", action);
+            }
+        }
+    }
+
+    // `last` is the move that led here, -1 for the deal
+    void checkKeys(const Klondike::State& state, unsigned seed, int ply, int last) {
+        Klondike::State fresh = state;
+        fresh.rehash();
+        if (fresh.hash() != state.hash()) fail(seed, ply, "hash() drifted from rehash() after this move", last);
+        if (fresh.canonicalHash() != state.canonicalHash()) fail(seed, ply, "canonicalHash() drifted from rehash() after this move", last);
+    }
+
+    // compared as raw bytes, State is trivially copyable and apply()/undo() never touch its padding
+    void checkUndo(Klondike::State& state, const Klondike::MoveList& moves, unsigned seed, int ply) {
+        unsigned char before[sizeof(Klondike::State)];
+        std::memcpy(before, &state, sizeof(before));
+        for (const Klondike::Move& move : moves) {
+            const Klondike::Undo record = Klondike::apply(state, move);
+            Klondike::undo(state, record);
+            if (std::memcmp(before, &state, sizeof(before)) != 0) {
+                fail(seed, ply, "undo() didn't restore the position", Klondike::actionOf(move));
+                std::memcpy(&state, before, sizeof(before)); // carry on from the right position
+            }
+        }
+    }
+}
+
+int main(int argc, char* argv[]) {
+    const int deals = (argc > 1) ? std::atoi(argv[1]) : 1000;
+    const unsigned first = (argc > 2) ? static_cast<unsigned>(std::strtoul(argv[2], nullptr, 10)) : 0;
+
+    for (int action = 0; action < Klondike::ACTION_COUNT; ++action) {
+        if (Klondike::actionOf(Klondike::moveOf(action)) != action) fail(0, 0, "actionOf(moveOf(action)) != action", action);
+    }
+
+    long positions = 0;
+    for (int d = 0; d < deals; ++d) {
+        const unsigned seed = first + static_cast<unsigned>(d);
+        Klondike::State state;
+        Klondike::deal(state, seed);
+        std::mt19937 rng(seed);
+        Klondike::MoveList moves;
+        int last = -1;
+        for (int ply = 0; ply < MaxMovesPerDeal; ++ply) {
+            Klondike::legalMoves(state, moves);
+            checkMoves(state, moves, seed, ply);
+            checkKeys(state, seed, ply, last);
+            checkUndo(state, moves, seed, ply);
+            positions++;
+            if (moves.empty() || state.isWon() || state.isStalled()) break;
+            const Klondike::Move& move = moves[static_cast<int>(rng() % static_cast<unsigned>(moves.size()))];
+            last = Klondike::actionOf(move);
+            Klondike::apply(state, move);
+        }
+    }
+
+    std::printf("%d deals, %ld positions checked: %d failures\n", deals, positions, failures);
+    return failures ? 1 : 0;
+}
@@ -0,0 +1,115 @@
+// Bakes every PNG under an asset directory into one pack of raw RGBA32 pixels (engine/assetpack.hpp):
+//   g++ -std=c++17 -O2 -I. tools/pack.cpp -o pack -lSDL2 -lSDL2_image
+//   ./pack [asset_dir] [out_file] [--scale WxH]... [--full]
+// Defaults to assets and assets/assets.pack. Card images (anything under a cards/ directory) are stored at
+// every --scale size instead of their full size, e.g. --scale 328x465 for the GUI's atlas cells: full-size
+// cards are 655x930 and nothing draws them that big. --full keeps the full-size cards as well.
+// Without --scale everything is stored at full size.
+// Run it from the repo root: entries are named by the path the GUI opens, "assets/cards/back.png".
+
+#include <SDL2/SDL.h>
+#include <SDL2/SDL_image.h>
+
+#include <algorithm>
+#include <cstdio>
+#include <filesystem>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include "engine/assetpack.hpp"
+
+namespace {
+    SDL_Surface* decode(const std::string& path) {
+        SDL_Surface* loaded = IMG_Load(path.c_str());
+        SDL_Surface* image = loaded ? SDL_ConvertSurfaceFormat(loaded, SDL_PIXELFORMAT_RGBA32, 0) : nullptr;
+        if (loaded) SDL_FreeSurface(loaded);
+        return image;
+    }
+
+    // same nearest-neighbour scaling the GUI does when it has to scale at runtime
+    SDL_Surface* scaled(SDL_Surface* image, int width, int height) {
+        SDL_Surface* out = SDL_CreateRGBSurfaceWithFormat(0, width, height, 32, SDL_PIXELFORMAT_RGBA32);
+        if (!out) return nullptr;
+        SDL_SetSurfaceBlendMode(image, SDL_BLENDMODE_NONE);
+        SDL_BlitScaled(image, nullptr, out, nullptr);
+        return out;
+    }
+
+    bool add(Klondike::Pack::Writer& pack, const std::string& name, SDL_Surface* image) {
+        if (!pack.add(name, image->w, image->h, image->pixels, image->pitch)) {
+            std::fprintf(stderr, "Name too long for the pack: %s\n", name.c_str());
+            return false;
+        }
+        return true;
+    }
+}
+
+int main(int argc, char* argv[]) {
+    std::vector<std::string> positional;
+    std::vector<std::pair<int, int>> scales;
+    bool full = false;
+    for (int i = 1; i < argc; ++i) {
+        const std::string arg = argv[i];
+        int width = 0, height = 0;
+        if (arg == "--full") {
+            full = true;
+        } else if (arg == "--scale" && i + 1 < argc) {
+            if (std::sscanf(argv[++i], "%dx%d", &width, &height) != 2 || width <= 0 || height <= 0) {
+                std::fprintf(stderr, "Bad --scale %s, expected WxH\n", argv[i]);
+                return 1;
+            }
+            scales.emplace_back(width, height);
+        } else {
+            positional.push_back(arg);
+        }
+    }
+    const std::string dir = positional.size() > 0 ? positional[0] : "assets";
+    const std::string out = positional.size() > 1 ? positional[1] : dir + "/assets.pack";
+
+    if (IMG_Init(IMG_INIT_PNG) == 0) {
+        std::fprintf(stderr, "Can't initialise SDL Image: %s\n", SDL_GetError());
+        return 1;
+    }
+
+    std::vector<std::string> paths;
+    std::error_code error;
+    for (const auto& file : std::filesystem::recursive_directory_iterator(dir, error)) {
+        if (file.is_regular_file() && file.path().extension() == ".png") paths.push_back(file.path().generic_string());
+    }
+    if (error) {
+        std::fprintf(stderr, "Can't read %s: %s\n", dir.c_str(), error.message().c_str());
+        return 1;
+    }
+    std::sort(paths.begin(), paths.end()); // same input, same file
+
+    Klondike::Pack::Writer pack;
+    bool ok = true;
+    for (const std::string& path : paths) {
+        SDL_Surface* image = decode(path);
+        if (!image) {
+            std::fprintf(stderr, "Unable to load image: %s, error: %s\n", path.c_str(), SDL_GetError());
+            ok = false;
+            continue;
+        }
+        const bool card = path.find("/cards/") != std::string::npos;
+        if (!card || scales.empty() || full) ok = add(pack, path, image) && ok;
+        if (card) {
+            for (const auto& [width, height] : scales) {
+                SDL_Surface* small = scaled(image, width, height);
+                ok = small && add(pack, Klondike::Pack::scaledName(path, width, height), small) && ok;
+                if (small) SDL_FreeSurface(small);
+            }
+        }
+        SDL_FreeSurface(image);
+    }
+    IMG_Quit();
+
+    if (!ok) return 1;
+    if (!pack.write(out)) {
+        std::fprintf(stderr, "Can't write %s\n", out.c_str());
+        return 1;
+    }
+    std::printf("Packed %zu images from %zu PNGs into %s\n", pack.size(), paths.size(), out.c_str());
+    return 0;
+}
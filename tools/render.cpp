@@ -0,0 +1,59 @@
+// Headless pixel renderer benchmark, no SDL or display needed (the asset pack comes from tools/pack.cpp):
+//   g++ -std=c++17 -O2 -I. tools/render.cpp -o render && ./render [width] [height] [frames] [pack] [out.ppm]
+// Plays random legal moves and renders every position; prints frames per second on one core, and writes the
+// last frame as a binary PPM when out.ppm is given.
+
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <string>
+
+#include "engine/pixels.hpp"
+#include "engine/rng.hpp"
+
+int main(int argc, char* argv[]) {
+    Klondike::PixelRenderer::Config config;
+    config.width = (argc > 1) ? std::atoi(argv[1]) : 84;
+    config.height = (argc > 2) ? std::atoi(argv[2]) : 84;
+    const int frames = (argc > 3) ? std::atoi(argv[3]) : 100000;
+    if (argc > 4) config.pack = argv[4];
+    const std::string out = (argc > 5) ? argv[5] : "";
+
+    Klondike::PixelRenderer renderer(config);
+    if (!renderer.ok()) return 1;
+
+    Klondike::State state;
+    Klondike::Rng rng(1, 0);
+    Klondike::MoveList moves;
+    std::uint64_t deal = 0;
+    Klondike::deal(state, deal);
+
+    unsigned checksum = 0; // keeps the frames from being optimised away
+    const std::uint8_t* pixels = nullptr;
+    const auto start = std::chrono::steady_clock::now();
+    for (int i = 0; i < frames; ++i) {
+        pixels = renderer.render(state);
+        checksum += pixels[(i * 7919u) % renderer.frameBytes()];
+        Klondike::legalMoves(state, moves);
+        if (moves.empty() || state.isWon() || state.isStalled()) Klondike::deal(state, ++deal);
+        else Klondike::apply(state, moves[static_cast<int>(rng.below(static_cast<std::uint32_t>(moves.size())))]);
+    }
+    const double seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+    std::printf("%dx%d: %.0f frames/s on one core, including the random moves (checksum %u)\n",
+                renderer.frameWidth(), renderer.frameHeight(), frames / seconds, checksum);
+
+    if (!out.empty() && pixels) {
+        Klondike::PixelRenderer::Config rgb = config; // PPM wants RGB whatever the benchmark used
+        rgb.format = Klondike::PixelRenderer::Format::Rgb;
+        Klondike::PixelRenderer writer(rgb);
+        std::FILE* file = std::fopen(out.c_str(), "wb");
+        if (!file) {
+            std::fprintf(stderr, "Can't write %s\n", out.c_str());
+            return 1;
+        }
+        std::fprintf(file, "P6\n%d %d\n255\n", writer.frameWidth(), writer.frameHeight());
+        std::fwrite(writer.render(state), 1, writer.frameBytes(), file);
+        std::fclose(file);
+    }
+    return 0;
+}
@@ -0,0 +1,116 @@
+// Plays whole games with the search players, no SDL needed:
+//   g++ -std=c++17 -O2 -pthread -I. tools/search.cpp -o search && ./search [--ismcts] [games] [simulations] [first_seed]
+// Mcts by default (it sees the whole deal), Ismcts with --ismcts (simulations are per determinization then).
+// Every game is played twice, on one thread and on several (at least two, even on a single core), and the two
+// runs must pick the same moves: results may not depend on the thread count. Every move the player picks must
+// be legal. Prints games won, mean score and moves per second; the exit code is 1 if a check failed.
+
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "engine/ismcts.hpp"
+#include "engine/mcts.hpp"
+
+namespace {
+    constexpr int MaxMovesPerGame = 500;
+    constexpr int IsmctsSamples = 8;
+
+    struct Game {
+        std::vector<int> actions;
+        int score {0};
+        bool won {false};
+        bool legal {true};
+    };
+
+    // pick(state) returns the player's move, played(move) tells it which move was played
+    template <typename Pick, typename Played>
+    Game playWith(std::uint64_t seed, Pick&& pick, Played&& played) {
+        Klondike::State state;
+        Klondike::deal(state, seed);
+        Game game;
+        while (!Klondike::isTerminal(state) && static_cast<int>(game.actions.size()) < MaxMovesPerGame) {
+            const Klondike::Move move = pick(state);
+            if (!Klondike::isLegal(state, move)) {
+                game.legal = false;
+                break;
+            }
+            game.actions.push_back(Klondike::actionOf(move));
+            Klondike::apply(state, move);
+            played(move);
+        }
+        game.score = state.getScore();
+        game.won = state.isWon();
+        return game;
+    }
+
+    Game playMcts(std::uint64_t seed, int simulations, int threads) {
+        Klondike::Mcts::Config config;
+        config.simulations = simulations;
+        config.trees = 2;
+        config.threads = threads;
+        config.seed = seed;
+        Klondike::Mcts mcts(config);
+        Klondike::State dealt;
+        Klondike::deal(dealt, seed);
+        mcts.setRoot(dealt); // playWith() deals the same game, the tree follows it through advance()
+        return playWith(seed, [&](const Klondike::State&) { return mcts.search(); }, [&](const Klondike::Move& move) { mcts.advance(move); });
+    }
+
+    Game playIsmcts(std::uint64_t seed, int simulations, int threads) {
+        Klondike::Ismcts::Config config;
+        config.samples = IsmctsSamples;
+        config.search.simulations = simulations;
+        config.threads = threads;
+        config.seed = seed;
+        Klondike::Ismcts ismcts(config);
+        return playWith(seed, [&](const Klondike::State& state) { return ismcts.search(state); }, [](const Klondike::Move&) {});
+    }
+}
+
+int main(int argc, char* argv[]) {
+    bool information_set = false;
+    std::vector<std::string> positional;
+    for (int i = 1; i < argc; ++i) {
+        const std::string arg = argv[i];
+        if (arg == "--ismcts") information_set = true;
+        else positional.push_back(arg);
+    }
+    const int games = positional.size() > 0 ? std::atoi(positional[0].c_str()) : 3;
+    const int simulations = positional.size() > 1 ? std::atoi(positional[1].c_str()) : 100;
+    const std::uint64_t first = positional.size() > 2 ? std::strtoull(positional[2].c_str(), nullptr, 10) : 0;
+    Game (*play)(std::uint64_t, int, int) = information_set ? playIsmcts : playMcts;
+    const int threads = std::max(2, static_cast<int>(std::thread::hardware_concurrency()));
+
+    int failures = 0, wins = 0;
+    long score = 0, moves = 0;
+    double seconds = 0;
+    for (int g = 0; g < games; ++g) {
+        const std::uint64_t seed = first + g;
+        const Game single = play(seed, simulations, 1);
+        const auto start = std::chrono::steady_clock::now();
+        const Game parallel = play(seed, simulations, threads);
+        seconds += std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+
+        if (!single.legal || !parallel.legal) {
+            std::fprintf(stderr, "deal %llu: the player picked an illegal move\n", static_cast<unsigned long long>(seed));
+            failures++;
+        }
+        if (single.actions != parallel.actions) {
+            std::fprintf(stderr, "deal %llu: 1 and %d threads played different games\n", static_cast<unsigned long long>(seed), threads);
+            failures++;
+        }
+        wins += parallel.won;
+        score += parallel.score;
+        moves += static_cast<long>(parallel.actions.size());
+    }
+
+    std::printf("%s, %d games, %d simulations per move, %d threads: %d won, mean score %.1f, %.1f moves/s, %d failures\n",
+                information_set ? "Ismcts" : "Mcts", games, simulations, threads, wins, games ? static_cast<double>(score) / games : 0.0,
+                seconds > 0 ? moves / seconds : 0.0, failures);
+    return failures ? 1 : 0;
+}